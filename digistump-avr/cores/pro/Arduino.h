@@ -113,10 +113,31 @@ void pwmReset(void);
 
 unsigned long millis(void);
 unsigned long micros(void);
+unsigned int maxInterruptLatency(void);
 void delay(unsigned long);
 void delayMicroseconds(unsigned int us);
 unsigned long pulseIn(uint8_t pin, uint8_t state, unsigned long timeout);
 
+// Cooperative scheduler: schedulerRun() calls the service (usbPoll() of a USB library,
+// which registers itself) and then the due tasks whose time budget still fits into the
+// service interval, so the service is never late as long as the budgets hold.  Tasks
+// run every periodMs (0: every pass) from schedulerDelay() and the delay() of the USB
+// libraries.  With a frame counter (usbSofCount) tasks run right after a frame started.
+// schedulerAdd() returns the slot or SCHEDULER_NONE (no free slot, budget too large).
+#ifndef SCHEDULER_TASKS
+#define SCHEDULER_TASKS 4
+#endif
+#define SCHEDULER_NONE 0xFF
+// Service interval of the USB libraries: usbPoll() at least every 10 ms keeps control
+// transfers moving (V-USB needs it every 50 ms at most), tasks get up to 10 ms each.
+#define SCHEDULER_USB_INTERVAL_US 10000
+void schedulerSetService(void (*poll)(void), uint16_t intervalUs);
+void schedulerSetFrameCounter(volatile uint8_t *counter);
+uint8_t schedulerAdd(void (*task)(void), uint16_t periodMs, uint16_t budgetUs);
+void schedulerRemove(uint8_t slot);
+void schedulerRun(void);
+void schedulerDelay(unsigned long ms);
+
 void shiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t val);
 uint8_t shiftIn(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder);
 
@@ -184,6 +205,14 @@ extern const uint8_t PROGMEM digital_pin_to_timer_PGM[];
 #ifndef TIMER_TO_USE_FOR_MILLIS
 #define TIMER_TO_USE_FOR_MILLIS                     0
 #endif
+
+/*
+  Record how late the millis timer interrupt is entered, for
+  maxInterruptLatency(), which returns zero if this is off.
+*/
+#ifndef MILLIS_TIMER_LATENCY
+#define MILLIS_TIMER_LATENCY                        0
+#endif
 /*
   Tone goes on whichever timer was not used for millis.
 */
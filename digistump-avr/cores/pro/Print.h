@@ -33,15 +33,17 @@
 #define DEC 10
 #define HEX 16
 #define OCT 8
-#ifdef BIN
+#if defined(BIN)
 #define ABIN BIN
-//One of the ATtiny84 registers has a bit called BIN, so rename it to avoid compiler warnings. 
+//One of the ATtiny84 registers has a bit called BIN, so rename it to avoid compiler warnings.
 #undef BIN
 #endif
 #define BIN 2
 
 #define ARDUINO_CORE_PRINTABLE_SUPPORT
 
+#define FLASHSTRING_SUPPORT
+
 class Print;
 
 /* Printable...*/
@@ -53,13 +55,48 @@ public:
 };
 
 /* ...Printable */
-    
+
 typedef struct
 {
   char c;
 }
 fstr_t;
 
+/* An argument of printf(). The constructor picks the kind from the type of the
+   argument at compile time, so printf() needs neither va_list nor vfprintf(). */
+
+struct PrintArg
+{
+  enum { INT, LONG, UNSIGNED, CHAR, FLOAT, STRING, FLASHSTRING, STRINGOBJECT, POINTER };
+
+  uint8_t kind;
+  union
+  {
+    long l;
+    unsigned long u;
+    double d;
+    const char *s;
+    const String *o;
+  }
+  v;
+
+  PrintArg() : kind(UNSIGNED) { v.u = 0; }
+  PrintArg(char c) : kind(CHAR) { v.l = c; }
+  PrintArg(signed char n) : kind(INT) { v.l = n; }
+  PrintArg(short n) : kind(INT) { v.l = n; }
+  PrintArg(int n) : kind(INT) { v.l = n; }
+  PrintArg(long n) : kind(LONG) { v.l = n; }
+  PrintArg(unsigned char n) : kind(UNSIGNED) { v.u = n; }
+  PrintArg(unsigned short n) : kind(UNSIGNED) { v.u = n; }
+  PrintArg(unsigned int n) : kind(UNSIGNED) { v.u = n; }
+  PrintArg(unsigned long n) : kind(UNSIGNED) { v.u = n; }
+  PrintArg(double d) : kind(FLOAT) { v.d = d; }
+  PrintArg(const char *s) : kind(STRING) { v.s = s; }
+  PrintArg(const __FlashStringHelper *s) : kind(FLASHSTRING) { v.s = (const char *)s; }
+  PrintArg(const String &o) : kind(STRINGOBJECT) { v.o = &o; }
+  PrintArg(const void *p) : kind(POINTER) { v.u = (uintptr_t)p; }
+};
+
 
 class Print
 {
@@ -67,18 +104,22 @@ class Print
     int write_error;
     size_t printNumber(unsigned long, uint8_t);
     size_t printFloat(double, uint8_t);
+    size_t printFlash(const char *, size_t);
+    size_t printPadding(char, uint8_t);
+    size_t printArg(const PrintArg &, char, uint8_t, uint8_t, uint8_t);
+    int16_t printFormat(const char *, bool, const PrintArg *, uint8_t);
   protected:
     void setWriteError(int err = 1) { write_error = err; }
   public:
     Print() : write_error(0) {}
-  
+
     int getWriteError() { return write_error; }
     void clearWriteError() { setWriteError(0); }
-  
+
     virtual size_t write(uint8_t) = 0;
     size_t write(const char *str) { return write((const uint8_t *)str, strlen(str)); }
     virtual size_t write(const uint8_t *buffer, size_t size);
-    
+
     size_t print(fstr_t*);
     size_t print(const String &);
     size_t print(const char[]);
@@ -103,6 +144,32 @@ class Print
     size_t println(unsigned long, int = DEC);
     size_t println(double, int = 2);
     size_t println(void);
+
+    // printf() without vfprintf(): %d %i %u %x %X %o %b %c %s %f %p %% with the
+    // flags '-' and '0', a width and a precision (%s: maximum length, %f: digits,
+    // 6 if not given, 10 at most). The argument types are known at compile time:
+    // 'l' and 'h' are accepted and ignored, %s also takes F() strings and String
+    // objects, %d of a char prints its code and %s of a number prints it as %d.
+    // Only %d, %i and %s print a negative number with a sign, %u and the other
+    // bases print it as unsigned, like printf(). Pointers (other than char *)
+    // print in hex with "0x", whatever the conversion. Text between the
+    // conversions is written in chunks.
+    template<typename... Args> int16_t printf(const char *format, const Args &... args)
+    {
+      const PrintArg list[] = { PrintArg(), args... };
+      return printFormat(format, false, list + 1, sizeof...(args));
+    }
+
+    #if defined(FLASHSTRING_SUPPORT)
+    size_t print(const __FlashStringHelper *ifsh);
+    size_t println(const __FlashStringHelper *ifsh);
+
+    template<typename... Args> int16_t printf(const __FlashStringHelper *format, const Args &... args)
+    {
+      const PrintArg list[] = { PrintArg(), args... };
+      return printFormat((const char *)format, true, list + 1, sizeof...(args));
+    }
+    #endif
 };
 
 #endif
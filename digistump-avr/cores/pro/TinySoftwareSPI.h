@@ -13,6 +13,7 @@
 #define _SPI_H_INCLUDED
 
 #include <stdio.h>
+#include <stddef.h>
 #include <Arduino.h>
 
 #define SPI_MODE0 0
@@ -28,21 +29,15 @@
 #define SPI_CLOCK_DIV8 0x05
 #define SPI_CLOCK_DIV32 0x06
 
-class SoftSPIClass;
-typedef byte (SoftSPIClass::*TransferFunction)(byte _data);
-
 class SoftSPIClass {
 public:
 	SoftSPIClass();
 private:
-	TransferFunction transferType;
-	byte noTransfer(byte _data);
-	byte transferMode0(byte _data);
-	byte transferMode1(byte _data);
-	byte transferMode2(byte _data);
-	byte transferMode3(byte _data);
+	template <uint8_t MODE> byte transferBits(byte _data);
+	byte transferByte(byte _data);
 public:
 	byte transfer(byte _data);
+	void transfer(void *_buf, size_t _count); // in place: each byte sent is replaced by the byte received
 	
 	// SPI Configuration methods
 	#if defined(SS) && defined(MOSI) && defined(MISO) && defined(SCK)
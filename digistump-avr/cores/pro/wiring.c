@@ -100,6 +100,19 @@
 volatile unsigned long millis_timer_overflow_count = 0;
 volatile unsigned long millis_timer_millis = 0;
 static unsigned char millis_timer_fract = 0;
+#if MILLIS_TIMER_LATENCY
+static volatile unsigned char millis_timer_max_latency = 0;
+
+#if defined(TCNT0) && (TIMER_TO_USE_FOR_MILLIS == 0) && !defined(TCW0)
+  #define MILLIS_TIMER_COUNT  TCNT0
+#elif defined(TCNT0L) && (TIMER_TO_USE_FOR_MILLIS == 0)
+  #define MILLIS_TIMER_COUNT  TCNT0L
+#elif defined(TCNT1) && (TIMER_TO_USE_FOR_MILLIS == 1)
+  #define MILLIS_TIMER_COUNT  TCNT1
+#elif defined(TCNT1L) && (TIMER_TO_USE_FOR_MILLIS == 1)
+  #define MILLIS_TIMER_COUNT  TCNT1L
+#endif
+#endif
 #if (TIMER_TO_USE_FOR_MILLIS == 0)
 
 #if defined(TIMER0_OVF_vect)
@@ -130,6 +143,13 @@ SIGNAL(TIM1_OVF_vect)
   // (volatile variables must be read from memory on every access)
   unsigned long m = millis_timer_millis;
   unsigned char f = millis_timer_fract;
+#if MILLIS_TIMER_LATENCY
+  // ticks since the overflow: how long this interrupt was held off
+  unsigned char t = MILLIS_TIMER_COUNT;
+
+  if (t > millis_timer_max_latency)
+    millis_timer_max_latency = t;
+#endif
 
 /* rmv: The code below generates considerably less code (emtpy Sketch is 326 versus 304)...
 
@@ -179,6 +199,27 @@ unsigned long millis()
   return m;
 }
 
+// longest delay of the millis timer interrupt since the last call, in microseconds:
+// a sample of the time interrupts were disabled (by cli() or another handler), every
+// overflow. Windows of more than one overflow period are not seen correctly.
+// Always zero unless MILLIS_TIMER_LATENCY is set (Arduino.h).
+unsigned int maxInterruptLatency(void)
+{
+#if MILLIS_TIMER_LATENCY
+  unsigned char t;
+  uint8_t oldSREG = SREG;
+
+  cli();
+  t = millis_timer_max_latency;
+  millis_timer_max_latency = 0;
+  SREG = oldSREG;
+
+  return clockCyclesToMicroseconds((unsigned long)t * MillisTimer_Prescale_Value);
+#else
+  return 0;
+#endif
+}
+
 unsigned long micros() 
 {
   unsigned long m;
@@ -27,6 +27,129 @@
 #include "Arduino.h"
 #include "Print.h"
 
+// Conversions without division /////////////////////////////////////////////////
+
+// The decimal digits count the subtractions of each power of ten (at most 9
+// each) instead of dividing by ten: a 32 bit division costs about 600 cycles
+// on the AVR, which is more than the subtractions of a whole number.
+
+static const unsigned long powersOfTen[] PROGMEM =
+{
+  1000000000UL, 100000000UL, 10000000UL, 1000000UL, 100000UL, 10000UL, 1000UL, 100UL, 10UL
+};
+
+// writes the digits of n in the given base to buf (32 bytes for base 2), no
+// terminating zero, returns the number of digits
+static uint8_t formatNumber(char *buf, unsigned long n, uint8_t base, char a)
+{
+  uint8_t len = 0;
+
+  if (base == 10) {
+    if (n < 65536UL) {
+      // 16 bit subtractions for the small numbers, which are the common ones
+      unsigned int m = n;
+      for (uint8_t i = 5; i < 9; i++) {
+        unsigned int p = pgm_read_dword(&powersOfTen[i]);
+        char c = '0';
+        while (m >= p) {
+          m -= p;
+          c++;
+        }
+        if (c != '0' || len) buf[len++] = c;
+      }
+      buf[len++] = '0' + m;
+    } else {
+      for (uint8_t i = 0; i < 9; i++) {
+        unsigned long p = pgm_read_dword(&powersOfTen[i]);
+        char c = '0';
+        while (n >= p) {
+          n -= p;
+          c++;
+        }
+        if (c != '0' || len) buf[len++] = c;
+      }
+      buf[len++] = '0' + (uint8_t)n;
+    }
+    return len;
+  }
+
+  uint8_t shift = base == 2 ? 1 : base == 8 ? 3 : base == 16 ? 4 : 0;
+
+  if (shift) {
+    // powers of two: shifts and masks
+    uint8_t mask = base - 1;
+    len = 1;
+    for (unsigned long t = n >> shift; t; t >>= shift) len++;
+    for (uint8_t i = len; i--; ) {
+      uint8_t c = (uint8_t)n & mask;
+      buf[i] = c < 10 ? c + '0' : c + a - 10;
+      n >>= shift;
+    }
+    return len;
+  }
+
+  // any other base still has to divide
+  char tmp[8 * sizeof(long)];
+  char *str = &tmp[sizeof(tmp)];
+  do {
+    unsigned long m = n;
+    n /= base;
+    char c = m - base * n;
+    *--str = c < 10 ? c + '0' : c + a - 10;
+  } while (n);
+  len = &tmp[sizeof(tmp)] - str;
+  memcpy(buf, str, len);
+  return len;
+}
+
+// digits after the point are limited to PRINT_FLOAT_DIGITS: a float of the AVR
+// has about 7 significant digits
+#define PRINT_FLOAT_DIGITS 10
+
+// writes number with the given digits after the point to buf (24 bytes), no
+// terminating zero, returns the length
+static uint8_t formatFloat(char *buf, double number, uint8_t digits)
+{
+  uint8_t len = 0;
+
+  if (digits > PRINT_FLOAT_DIGITS) digits = PRINT_FLOAT_DIGITS;
+
+  // Handle negative numbers
+  if (number < 0.0)
+  {
+     buf[len++] = '-';
+     number = -number;
+  }
+
+  // Round correctly so that print(1.999, 2) prints as "2.00"
+  double rounding = 0.5;
+  for (uint8_t i=0; i<digits; ++i)
+    rounding *= 0.1;
+
+  number += rounding;
+
+  // Extract the integer part of the number and print it
+  unsigned long int_part = (unsigned long)number;
+  double remainder = number - (double)int_part;
+  len += formatNumber(buf + len, int_part, 10, 'A');
+
+  // Print the decimal point, but only if there are digits beyond
+  if (digits > 0) {
+    buf[len++] = '.';
+  }
+
+  // Extract digits from the remainder one at a time
+  while (digits-- > 0)
+  {
+    remainder *= 10.0;
+    uint8_t toPrint = (uint8_t)remainder;
+    buf[len++] = '0' + toPrint;
+    remainder -= toPrint;
+  }
+
+  return len;
+}
+
 // Public Methods //////////////////////////////////////////////////////////////
 
 /* default implementation: may be overridden */
@@ -77,13 +200,10 @@ size_t Print::print(long n, int base)
 {
   if (base == 0) {
     return write(n);
-  } else if (base == 10) {
-    int t = 0;
-    if (n < 0) {
-      t = print('-');
-      n = -n;
-    }
-    return printNumber(n, 10) + t;
+  } else if (base == 10 && n < 0) {
+    char buf[11];
+    buf[0] = '-';
+    return write((const uint8_t *)buf, 1 + formatNumber(buf + 1, -(unsigned long)n, 10, 'A'));
   } else {
     return printNumber(n, base);
   }
@@ -102,18 +222,7 @@ size_t Print::print(double n, int digits)
 
 size_t Print::print( fstr_t *s )
 {
-  size_t n = 0;
-  char ch;
-
-  ch = pgm_read_byte( s );
-  while ( ch != 0 )
-  {
-    write( ch );
-    ++s;
-    ++n;
-    ch = pgm_read_byte( s );
-  }
-  return( n );
+  return( printFlash( (const char *) s, (size_t) -1 ) );
 }
 
 size_t Print::println(void)
@@ -200,36 +309,11 @@ size_t Print::println( fstr_t *s )
   return( n );
 }
 
-static int16_t printf_putchar(char c, FILE *fp)
-{
-  ((class Print *)(fdev_get_udata(fp)))->write((uint8_t)c);
-  return 0;
-}
-
-int16_t Print::printf(const char *ifsh, ...)
-{
-  FILE f;
-  va_list ap;
-
-  fdev_setup_stream(&f, printf_putchar, NULL, _FDEV_SETUP_WRITE);
-  fdev_set_udata(&f, this);
-  va_start(ap, ifsh);
-  return vfprintf(&f, ifsh, ap);
-}
-
 #if defined(FLASHSTRING_SUPPORT)
 
 size_t Print::print(const __FlashStringHelper *ifsh)
 {
-  PGM_P p = reinterpret_cast<PGM_P>(ifsh);
-  size_t n = 0;
-  while (1) {
-    unsigned char c = pgm_read_byte(p++);
-    if (c == 0) break;
-    if (write(c)) n++;
-    else break;
-  }
-  return n;
+  return printFlash(reinterpret_cast<PGM_P>(ifsh), (size_t)-1);
 }
 
 size_t Print::println(const __FlashStringHelper *ifsh)
@@ -239,76 +323,187 @@ size_t Print::println(const __FlashStringHelper *ifsh)
   return n;
 }
 
-int16_t Print::printf(const __FlashStringHelper *ifsh, ...)
-{
-  FILE f;
-  va_list ap;
-
-  fdev_setup_stream(&f, printf_putchar, NULL, _FDEV_SETUP_WRITE);
-  fdev_set_udata(&f, this);
-  va_start(ap, ifsh);
-  return vfprintf_P(&f, (const char *)ifsh, ap);
-}
-
 #endif
 
 // Private Methods /////////////////////////////////////////////////////////////
 
 size_t Print::printNumber(unsigned long n, uint8_t base) {
-  char buf[8 * sizeof(long) + 1]; // Assumes 8-bit chars plus zero byte.
-  char *str = &buf[sizeof(buf) - 1];
-
-  *str = '\0';
+  char buf[8 * sizeof(long)];
 
   // prevent crash if called with base == 1
   if (base < 2) base = 10;
 
-  do {
-    unsigned long m = n;
-    n /= base;
-    char c = m - base * n;
-    *--str = c < 10 ? c + '0' : c + 'A' - 10;
-  } while(n);
-
-  return write(str);
+  return write((const uint8_t *)buf, formatNumber(buf, n, base, 'A'));
 }
 
 size_t Print::printFloat(double number, uint8_t digits)
 {
+  char buf[24];
+
+  return write((const uint8_t *)buf, formatFloat(buf, number, digits));
+}
+
+// writes up to 'size' bytes of a string in flash, up to its terminating zero,
+// copied in chunks
+size_t Print::printFlash(const char *p, size_t size)
+{
+  char buf[16];
   size_t n = 0;
 
-  // Handle negative numbers
-  if (number < 0.0)
-  {
-     n += print('-');
-     number = -number;
+  while (size) {
+    uint8_t len = 0;
+    char c;
+    while (len < sizeof(buf) && len < size && (c = pgm_read_byte(p++)) != 0)
+      buf[len++] = c;
+    if (len == 0) break;
+    size_t w = write((const uint8_t *)buf, len);
+    n += w;
+    if (w < len || len < sizeof(buf)) break;
+    size -= len;
   }
+  return n;
+}
 
-  // Round correctly so that print(1.999, 2) prints as "2.00"
-  double rounding = 0.5;
-  for (uint8_t i=0; i<digits; ++i)
-    rounding /= 10.0;
+size_t Print::printPadding(char c, uint8_t count)
+{
+  char buf[8];
+  size_t n = 0;
 
-  number += rounding;
+  memset(buf, c, sizeof(buf));
+  while (count) {
+    uint8_t len = count < sizeof(buf) ? count : sizeof(buf);
+    n += write((const uint8_t *)buf, len);
+    count -= len;
+  }
+  return n;
+}
 
-  // Extract the integer part of the number and print it
-  unsigned long int_part = (unsigned long)number;
-  double remainder = number - (double)int_part;
-  n += print(int_part);
+#define FORMAT_LEFT 1   // '-' flag
+#define FORMAT_ZERO 2   // '0' flag
+#define FORMAT_PRECISION 4
 
-  // Print the decimal point, but only if there are digits beyond
-  if (digits > 0) {
-    n += print(".");
+size_t Print::printArg(const PrintArg &arg, char conversion, uint8_t flags, uint8_t width, uint8_t precision)
+{
+  char buf[8 * sizeof(long) + 1];
+  const char *str = buf;
+  size_t len = 0;
+  bool flash = false;
+  uint8_t prefix = 0;   // sign or "0x" of buf, written before the '0' padding
+  uint8_t base = 10;
+  char a = 'a';
+
+  switch (conversion) {
+    case 'X': a = 'A'; base = 16; break;
+    case 'x': case 'p': base = 16; break;
+    case 'o': base = 8; break;
+    case 'b': base = 2; break;
   }
 
-  // Extract digits from the remainder one at a time
-  while (digits-- > 0)
-  {
-    remainder *= 10.0;
-    int toPrint = int(remainder);
-    n += print(toPrint);
-    remainder -= toPrint;
+  if (arg.kind == PrintArg::FLOAT) {
+    len = formatFloat(buf, arg.v.d, flags & FORMAT_PRECISION ? precision : 6);
+    prefix = buf[0] == '-';
+  } else if (arg.kind == PrintArg::STRING || arg.kind == PrintArg::FLASHSTRING || arg.kind == PrintArg::STRINGOBJECT) {
+    if (arg.kind == PrintArg::STRINGOBJECT) {
+      str = arg.v.o->c_str();
+      len = arg.v.o->length();
+    } else if (arg.kind == PrintArg::FLASHSTRING) {
+      str = arg.v.s;
+      len = strlen_P(str);
+      flash = true;
+    } else {
+      str = arg.v.s;
+      len = strlen(str);
+    }
+    if ((flags & FORMAT_PRECISION) && precision < len) len = precision;
+    flags &= ~FORMAT_ZERO;
+  } else if (conversion == 'c' || (arg.kind == PrintArg::CHAR && conversion == 's')) {
+    buf[0] = arg.v.l;
+    len = 1;
+    flags &= ~FORMAT_ZERO;
+  } else if (arg.kind == PrintArg::POINTER || conversion == 'p') {
+    buf[0] = '0';
+    buf[1] = 'x';
+    prefix = 2;
+    len = 2 + formatNumber(buf + 2, arg.v.u, 16, a);
+  } else if ((conversion == 'd' || conversion == 'i' || conversion == 's') && arg.kind != PrintArg::UNSIGNED && arg.v.l < 0) {
+    buf[0] = '-';
+    prefix = 1;
+    len = 1 + formatNumber(buf + 1, -(unsigned long)arg.v.l, 10, a);
+  } else {
+    // as printf(): the types up to int are promoted to a 16 bit int
+    unsigned long u = arg.kind == PrintArg::INT || arg.kind == PrintArg::CHAR ? (unsigned int)arg.v.l : arg.v.u;
+    len = formatNumber(buf, u, base, a);
   }
 
+  size_t n = 0;
+  uint8_t pad = width > len ? width - len : 0;
+
+  if (!(flags & FORMAT_LEFT)) {
+    if ((flags & FORMAT_ZERO) && prefix) {
+      // the sign goes before the zeros
+      n += write((const uint8_t *)str, prefix);
+      str += prefix;
+      len -= prefix;
+    }
+    n += printPadding(flags & FORMAT_ZERO ? '0' : ' ', pad);
+  }
+  n += flash ? printFlash(str, len) : write((const uint8_t *)str, len);
+  if (flags & FORMAT_LEFT)
+    n += printPadding(' ', pad);
+  return n;
+}
+
+static inline char formatChar(const char *&p, bool flash)
+{
+  char c = flash ? pgm_read_byte(p) : *p;
+  p++;
+  return c;
+}
+
+int16_t Print::printFormat(const char *format, bool flash, const PrintArg *arg, uint8_t count)
+{
+  char buf[16];
+  uint8_t len = 0;
+  size_t n = 0;
+
+  for (;;) {
+    char c = formatChar(format, flash);
+    if (c == 0) break;
+    if (c == '%' && (c = formatChar(format, flash)) != '%') {
+      if (len) {
+        n += write((const uint8_t *)buf, len);
+        len = 0;
+      }
+      uint8_t flags = 0, width = 0, precision = 0;
+      for (;; c = formatChar(format, flash)) {
+        if (c == '-') flags |= FORMAT_LEFT;
+        else if (c == '0') flags |= FORMAT_ZERO;
+        else break;
+      }
+      for (; c >= '0' && c <= '9'; c = formatChar(format, flash))
+        width = width * 10 + c - '0';
+      if (c == '.') {
+        flags |= FORMAT_PRECISION;
+        while ((c = formatChar(format, flash)) >= '0' && c <= '9')
+          precision = precision * 10 + c - '0';
+      }
+      while (c == 'l' || c == 'h')
+        c = formatChar(format, flash);
+      if (c == 0) break;
+      if (count) {
+        n += printArg(*arg++, c, flags, width, precision);
+        count--;
+      }
+      continue;
+    }
+    // text and "%%": collected for one write()
+    buf[len++] = c;
+    if (len == sizeof(buf)) {
+      n += write((const uint8_t *)buf, len);
+      len = 0;
+    }
+  }
+  if (len)
+    n += write((const uint8_t *)buf, len);
   return n;
 }
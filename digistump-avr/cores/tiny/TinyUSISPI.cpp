@@ -0,0 +1,89 @@
+/*
+ * USI based SPI Master Library for Tiny core.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ */
+
+#include "TinyUSISPI.h"
+#include "core_pins.h"
+#include "core_usi.h"
+
+#if defined( USICR ) && defined( USI_PORT ) && defined( CORE_USI_SCK_PIN )
+
+USISPIClass::USISPIClass(){
+	_bitOrder = MSBFIRST;
+	_mode = SPI_MODE0;
+	_fast = true;
+	_running = false;
+}
+
+void USISPIClass::begin(){
+	pinMode(CORE_USI_DO_PIN, OUTPUT);
+	pinMode(CORE_USI_DI_PIN, INPUT);
+	pinMode(CORE_USI_SCK_PIN, OUTPUT);
+	digitalWrite(CORE_USI_SCK_PIN, (_mode & 0x02) ? HIGH : LOW);
+	USI_ThreeWireEnable();
+	_running = true;
+}
+
+void USISPIClass::end(){
+	USI_Disable();
+	_running = false;
+}
+
+byte USISPIClass::transfer(byte _data){
+	if (!_running) return 0xFF;
+	if (_bitOrder == LSBFIRST) _data = USI_ReverseBits(_data);
+	if (_fast && _mode == SPI_MODE0) {
+		_data = USI_TransferFast(_data);
+	} else {
+		_data = USI_Transfer(_data, _mode == SPI_MODE1 || _mode == SPI_MODE2);
+	}
+	if (_bitOrder == LSBFIRST) _data = USI_ReverseBits(_data);
+	return _data;
+}
+
+void USISPIClass::transfer(void *_buf, size_t _count){
+	byte *p = (byte *)_buf;
+
+	if (!_running) return;
+	if (_fast && _mode == SPI_MODE0 && _bitOrder == MSBFIRST) {
+		//The common case without any test per byte.
+		while (_count--) {
+			*p = USI_TransferFast(*p);
+			p++;
+		}
+	} else {
+		while (_count--) {
+			*p = transfer(*p);
+			p++;
+		}
+	}
+}
+
+void USISPIClass::setBitOrder(uint8_t bitOrder) {
+	_bitOrder = bitOrder;
+}
+
+void USISPIClass::setDataMode(uint8_t mode)
+{
+	_mode = (mode <= SPI_MODE3) ? mode : SPI_MODE0;
+	//Idle level of the clock (CPOL).
+	if (_mode & 0x02) {
+		USI_PORT |= _BV(USI_SCK_BIT);
+	} else {
+		USI_PORT &= ~_BV(USI_SCK_BIT);
+	}
+}
+
+void USISPIClass::setClockDivider(uint8_t rate)
+{
+	_fast = (rate == SPI_CLOCK_DIV2 || rate == SPI_CLOCK_DIV4);
+}
+
+USISPIClass SPI;
+
+#endif
@@ -0,0 +1,61 @@
+/*
+ * USI based SPI Master Library for Tiny core.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 2
+ * or the GNU Lesser General Public License version 2.1, both as
+ * published by the Free Software Foundation.
+ *
+ * The pins are fixed by the USI: CORE_USI_DO_PIN (MOSI), CORE_USI_DI_PIN (MISO)
+ * and CORE_USI_SCK_PIN, i.e. PB1, PB0 and PB2 on the ATtiny85 (Digispark P1, P0
+ * and P2). The slave select pin is driven by the sketch.
+ *
+ * SPI_CLOCK_DIV2 and SPI_CLOCK_DIV4 in mode 0 use the unrolled strobe loop,
+ * F_CPU/2 (8.25 MHz on the Digispark); the other dividers and modes use the USI
+ * counter loop, about F_CPU/10.
+ */
+
+#ifndef _SPI_H_INCLUDED
+//Uses the same guard as the SPI class as the two cannot be used together
+#define _SPI_H_INCLUDED
+
+#include <stddef.h>
+#include <Arduino.h>
+
+#define SPI_MODE0 0
+#define SPI_MODE1 1
+#define SPI_MODE2 2
+#define SPI_MODE3 3
+
+#define SPI_CLOCK_DIV4 0x00
+#define SPI_CLOCK_DIV16 0x01
+#define SPI_CLOCK_DIV64 0x02
+#define SPI_CLOCK_DIV128 0x03
+#define SPI_CLOCK_DIV2 0x04
+#define SPI_CLOCK_DIV8 0x05
+#define SPI_CLOCK_DIV32 0x06
+
+class USISPIClass {
+public:
+	USISPIClass();
+
+	byte transfer(byte _data);
+	void transfer(void *_buf, size_t _count); // in place: each byte sent is replaced by the byte received
+
+	// SPI Configuration methods
+	void begin();
+	void end();
+
+	void setBitOrder(uint8_t);
+	void setDataMode(uint8_t);
+	void setClockDivider(uint8_t);
+private:
+	byte _bitOrder;
+	byte _mode;
+	boolean _fast;
+	boolean _running;
+};
+
+extern USISPIClass SPI;
+
+#endif
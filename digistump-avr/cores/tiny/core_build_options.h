@@ -171,4 +171,15 @@
 #endif
 
 
+/*=============================================================================
+  Record how late the millis timer interrupt is entered, for
+  maxInterruptLatency().  Off by default: it costs a few cycles on every
+  overflow and maxInterruptLatency() then always returns zero.
+=============================================================================*/
+
+#if ! defined( MILLIS_TIMER_LATENCY )
+  #define MILLIS_TIMER_LATENCY                      0
+#endif
+
+
 #endif
@@ -62,6 +62,10 @@
 #define CORE_INT0_PIN  PIN_D2
 #define CORE_INT1_PIN  PIN_D3
 
+#define CORE_USI_DI_PIN   PIN_B5
+#define CORE_USI_DO_PIN   PIN_B6
+#define CORE_USI_SCK_PIN  PIN_B7
+
 #define CORE_OC0A_PIN  PIN_B2
 #define CORE_OC0B_PIN  PIN_D5
 #define CORE_OC1A_PIN  PIN_B3
@@ -118,6 +122,10 @@
 
 #define CORE_INT0_PIN  PIN_B2
 
+#define CORE_USI_DI_PIN   PIN_A6
+#define CORE_USI_DO_PIN   PIN_A5
+#define CORE_USI_SCK_PIN  PIN_A4
+
 #define CORE_OC0A_PIN  PIN_B2
 #define CORE_OC0B_PIN  PIN_A7
 #define CORE_OC1A_PIN  PIN_A6
@@ -168,6 +176,10 @@
 
 #define CORE_INT0_PIN  PIN_B2
 
+#define CORE_USI_DI_PIN   PIN_B0
+#define CORE_USI_DO_PIN   PIN_B1
+#define CORE_USI_SCK_PIN  PIN_B2
+
 #define CORE_OC0A_PIN  PIN_B0
 #define CORE_OC0B_PIN  PIN_B1
 #define CORE_OC1A_PIN  PIN_B1
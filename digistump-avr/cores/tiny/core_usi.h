@@ -0,0 +1,126 @@
+/*==============================================================================
+
+  core_usi.h - Veneer for the Universal Serial Interface in three-wire mode.
+
+  This file is part of Arduino-Tiny.
+
+  Arduino-Tiny is free software: you can redistribute it and/or modify it
+  under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  Arduino-Tiny is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+  License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Arduino-Tiny.  If not, see <http://www.gnu.org/licenses/>.
+
+==============================================================================*/
+
+#ifndef core_usi_h
+#define core_usi_h
+
+#include <avr/io.h>
+
+#include "core_build_options.h"
+#include "core_macros.h"
+
+
+/*=============================================================================
+  USI pins (see CORE_USI_xx_PIN in core_pins.h for the Arduino pin numbers)
+=============================================================================*/
+
+#if defined( __AVR_ATtinyX313__ )
+  #define USI_PORT      PORTB
+  #define USI_DDR       DDRB
+  #define USI_DI_BIT    PB5
+  #define USI_DO_BIT    PB6
+  #define USI_SCK_BIT   PB7
+#elif defined( __AVR_ATtinyX4__ )
+  #define USI_PORT      PORTA
+  #define USI_DDR       DDRA
+  #define USI_DI_BIT    PA6
+  #define USI_DO_BIT    PA5
+  #define USI_SCK_BIT   PA4
+#elif defined( __AVR_ATtinyX5__ )
+  #define USI_PORT      PORTB
+  #define USI_DDR       DDRB
+  #define USI_DI_BIT    PB0
+  #define USI_DO_BIT    PB1
+  #define USI_SCK_BIT   PB2
+#endif
+
+
+#if defined( USICR ) && defined( USI_PORT )
+
+/*=============================================================================
+  Three-wire (SPI) master.  DO is driven by the USI only while its DDR bit is
+  set, USCK is the PORT bit toggled by USITC: the pins go back to digitalWrite()
+  control after USI_Disable().
+=============================================================================*/
+
+__attribute__((always_inline)) static inline void USI_ThreeWireEnable( void )
+{
+  USICR = MASK1( USIWM0 );
+}
+
+__attribute__((always_inline)) static inline void USI_Disable( void )
+{
+  USICR = 0;
+}
+
+/*
+  Mode 0 only, F_CPU/2: the shift register is clocked by the software strobe
+  (USICLK) on the falling edge of USCK, no counter is needed.  USCK must be low.
+*/
+__attribute__((always_inline)) static inline uint8_t USI_TransferFast( uint8_t data )
+{
+  uint8_t lo = MASK2( USIWM0, USITC );
+  uint8_t hi = MASK3( USIWM0, USITC, USICLK );
+
+  USIDR = data;
+  USICR = lo; USICR = hi;
+  USICR = lo; USICR = hi;
+  USICR = lo; USICR = hi;
+  USICR = lo; USICR = hi;
+  USICR = lo; USICR = hi;
+  USICR = lo; USICR = hi;
+  USICR = lo; USICR = hi;
+  USICR = lo; USICR = hi;
+  return( USIDR );
+}
+
+/*
+  Any mode, about F_CPU/10: USCK is toggled by USITC and the shift register
+  follows its edges (USICS0 set: sample on the falling edge, for the modes 1
+  and 2), the 4-bit counter tells when 16 edges are done.  The idle level of
+  USCK (CPOL) is the PORT bit before the transfer.
+*/
+__attribute__((always_inline)) static inline uint8_t USI_Transfer( uint8_t data, uint8_t cs0 )
+{
+  uint8_t cr = MASK4( USIWM0, USICS1, USICLK, USITC ) | ( cs0 ? MASK1( USICS0 ) : 0 );
+
+  USIDR = data;
+  USISR = MASK1( USIOIF );
+  do
+  {
+    USICR = cr;
+  }
+  while ( ! (USISR & MASK1( USIOIF )) );
+  return( USIDR );
+}
+
+/* The USI shifts MSB first only */
+__attribute__((always_inline)) static inline uint8_t USI_ReverseBits( uint8_t b )
+{
+  b = (b >> 4) | (b << 4);
+  b = ((b >> 2) & 0x33) | ((b << 2) & 0xCC);
+  b = ((b >> 1) & 0x55) | ((b << 1) & 0xAA);
+  return( b );
+}
+
+#endif
+
+#endif
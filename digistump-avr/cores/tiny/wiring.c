@@ -87,6 +87,9 @@
 volatile unsigned long millis_timer_overflow_count = 0;
 volatile unsigned long millis_timer_millis = 0;
 static unsigned char millis_timer_fract = 0;
+#if MILLIS_TIMER_LATENCY
+static volatile unsigned char millis_timer_max_latency = 0;
+#endif
 
 // bluebie changed isr to noblock so it wouldn't mess up USB libraries
 // Keyboard example works without ISR_NOBLOCK :-)
@@ -100,6 +103,13 @@ ISR(MILLISTIMER_OVF_vect)
   // (volatile variables must be read from memory on every access)
   unsigned long m = millis_timer_millis;
   unsigned char f = millis_timer_fract;
+#if MILLIS_TIMER_LATENCY
+  // ticks since the overflow: how long this interrupt was held off
+  unsigned char t = MillisTimer_GetCount();
+
+  if (t > millis_timer_max_latency)
+    millis_timer_max_latency = t;
+#endif
 
   f += FRACT_INC;
 
@@ -133,6 +143,38 @@ unsigned long millis()
 }
 
 unsigned long micros() 
+{
+#if (MillisTimer_Prescale_Value >= clockCyclesPerMicrosecond())
+  return millisTimerTicks() * (MillisTimer_Prescale_Value / clockCyclesPerMicrosecond());
+#else
+  return millisTimerTicks() / (clockCyclesPerMicrosecond() / MillisTimer_Prescale_Value);
+#endif
+}
+
+// longest delay of the millis timer interrupt since the last call, in microseconds:
+// a sample of the time interrupts were disabled (by cli() or another handler), every
+// overflow. Windows of more than one overflow period are not seen correctly.
+// Always zero unless MILLIS_TIMER_LATENCY is set (core_build_options.h).
+unsigned int maxInterruptLatency(void)
+{
+#if MILLIS_TIMER_LATENCY
+  unsigned char t;
+  uint8_t oldSREG = SREG;
+
+  cli();
+  t = millis_timer_max_latency;
+  millis_timer_max_latency = 0;
+  SREG = oldSREG;
+
+  return clockCyclesToMicroseconds((unsigned long)t * MillisTimer_Prescale_Value);
+#else
+  return 0;
+#endif
+}
+
+// raw count of the millis timer (MillisTimer_Prescale_Value cycles per tick), for
+// time stamps taken in interrupt handlers: no conversion on the fast path.
+unsigned long millisTimerTicks(void)
 {
   unsigned long m;
   uint8_t oldSREG = SREG, t;
@@ -146,11 +188,21 @@ unsigned long micros()
 
   SREG = oldSREG;
 
-#if (MillisTimer_Prescale_Value >= clockCyclesPerMicrosecond())
-  return ((m << 8) + t) * (MillisTimer_Prescale_Value / clockCyclesPerMicrosecond());
-#else
-  return ((m << 8) + t) / (clockCyclesPerMicrosecond() / MillisTimer_Prescale_Value);
-#endif
+  return (m << 8) + t;
+}
+
+// exact conversions (micros() truncates clockCyclesPerMicrosecond(), 3% off at 16.5 MHz)
+#define MICROSECONDS_PER_1000_TICKS  (clockCyclesToMicroseconds(MillisTimer_Prescale_Value * 1000UL))
+#define TICKS_PER_MILLISECOND        ((F_CPU / 1000L) / MillisTimer_Prescale_Value)
+
+unsigned long millisTimerTicksToMicroseconds(unsigned long ticks)
+{
+  return (ticks / 1000) * MICROSECONDS_PER_1000_TICKS + clockCyclesToMicroseconds((ticks % 1000) * MillisTimer_Prescale_Value);
+}
+
+unsigned long microsecondsToMillisTimerTicks(unsigned long us)
+{
+  return (us / 1000) * TICKS_PER_MILLISECOND + microsecondsToClockCycles(us % 1000) / MillisTimer_Prescale_Value;
 }
 
 void delay(unsigned long ms)
@@ -175,10 +175,42 @@ void analogWrite(uint8_t, int);
 
 unsigned long millis(void);
 unsigned long micros(void);
+unsigned int maxInterruptLatency(void);
 void delay(unsigned long);
 void delayMicroseconds(unsigned int us);
 unsigned long pulseIn(uint8_t pin, uint8_t state, unsigned long timeout);
 
+// Non-blocking pulseIn() on the external interrupt pins (INT0 = PB2 on the ATtiny85):
+// pulseInAsync() arms the measurement and returns at once (0 if the pin has no INTx),
+// the edges are time stamped in the interrupt handler. The result is polled with
+// pulseInAsyncReady()/pulseInAsyncWidth() or passed to 'done' (width 0 on timeout).
+// Timeouts are detected by pulseInAsyncReady() and pulseInAsyncPoll(). timeout = 0: none.
+uint8_t pulseInAsync(uint8_t pin, uint8_t state, unsigned long timeout, void (*done)(uint8_t pin, unsigned long width));
+uint8_t pulseInAsyncReady(uint8_t pin);
+unsigned long pulseInAsyncWidth(uint8_t pin);
+void pulseInAsyncCancel(uint8_t pin);
+void pulseInAsyncPoll(void);
+
+// Cooperative scheduler: schedulerRun() calls the service (usbPoll() of a USB library,
+// which registers itself) and then the due tasks whose time budget still fits into the
+// service interval, so the service is never late as long as the budgets hold.  Tasks
+// run every periodMs (0: every pass) from schedulerDelay() and the delay() of the USB
+// libraries.  With a frame counter (usbSofCount) tasks run right after a frame started.
+// schedulerAdd() returns the slot or SCHEDULER_NONE (no free slot, budget too large).
+#ifndef SCHEDULER_TASKS
+#define SCHEDULER_TASKS 4
+#endif
+#define SCHEDULER_NONE 0xFF
+// Service interval of the USB libraries: usbPoll() at least every 10 ms keeps control
+// transfers moving (V-USB needs it every 50 ms at most), tasks get up to 10 ms each.
+#define SCHEDULER_USB_INTERVAL_US 10000
+void schedulerSetService(void (*poll)(void), uint16_t intervalUs);
+void schedulerSetFrameCounter(volatile uint8_t *counter);
+uint8_t schedulerAdd(void (*task)(void), uint16_t periodMs, uint16_t budgetUs);
+void schedulerRemove(uint8_t slot);
+void schedulerRun(void);
+void schedulerDelay(unsigned long ms);
+
 void shiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t val);
 uint8_t shiftIn(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder);
 
@@ -172,6 +172,11 @@ extern "C"{
 
 typedef void (*voidFuncPtr)(void);
 
+// millis timer time base (wiring.c)
+unsigned long millisTimerTicks(void);
+unsigned long millisTimerTicksToMicroseconds(unsigned long ticks);
+unsigned long microsecondsToMillisTimerTicks(unsigned long us);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -22,6 +22,7 @@
   $Id: wiring.c 248 2007-02-03 15:36:30Z mellis $
 */
 
+#include "core_pins.h"
 #include "wiring_private.h"
 #include "pins_arduino.h"
 
@@ -67,3 +68,175 @@ unsigned long pulseIn(uint8_t pin, uint8_t state, unsigned long timeout)
 	// the interrupt handlers.
 	return clockCyclesToMicroseconds(width * 21 + 16); 
 }
+
+#if NUMBER_EXTERNAL_INTERRUPTS >= 1
+
+/* Asynchronous version: the pin is watched by its external interrupt (any change)
+ * and both edges are time stamped with the millis timer, so the width no longer
+ * depends on the loop timing nor on the other interrupts (resolution: one millis
+ * timer tick, 3.9 us at 16.5 MHz). */
+
+#define PULSE_IDLE     0
+#define PULSE_WAIT     1 // for the start of the pulse
+#define PULSE_IN       2 // for its end
+#define PULSE_DONE     3
+
+typedef struct {
+	volatile uint8_t *in;
+	uint8_t bit;
+	uint8_t stateMask;
+	volatile uint8_t phase;
+	unsigned long armed;   // all in millis timer ticks
+	unsigned long limit;
+	unsigned long start;
+	unsigned long width;   // 0: timeout
+	void (*done)(uint8_t pin, unsigned long width);
+} pulseAsync_t;
+
+static pulseAsync_t pulseAsync[NUMBER_EXTERNAL_INTERRUPTS];
+
+static int8_t pulseAsyncIndex(uint8_t pin)
+{
+#if defined(CORE_INT0_PIN)
+	if (pin == CORE_INT0_PIN) return EXTERNAL_INTERRUPT_0;
+#endif
+#if defined(CORE_INT1_PIN) && NUMBER_EXTERNAL_INTERRUPTS >= 2
+	if (pin == CORE_INT1_PIN) return EXTERNAL_INTERRUPT_1;
+#endif
+	return -1;
+}
+
+static uint8_t pulseAsyncPin(uint8_t idx)
+{
+#if defined(CORE_INT1_PIN) && NUMBER_EXTERNAL_INTERRUPTS >= 2
+	if (idx == EXTERNAL_INTERRUPT_1) return CORE_INT1_PIN;
+#endif
+	return CORE_INT0_PIN;
+}
+
+// called with interrupts disabled
+static void pulseAsyncEnd(uint8_t idx, unsigned long width)
+{
+	detachInterrupt(idx);
+	pulseAsync[idx].width = width;
+	pulseAsync[idx].phase = PULSE_DONE;
+}
+
+static void pulseAsyncEdge(uint8_t idx)
+{
+	pulseAsync_t *p = &pulseAsync[idx];
+	uint8_t oldSREG = SREG;
+	unsigned long now;
+	uint8_t level, ended = 0;
+
+	// the core handlers run with interrupts enabled: keep the edges in order
+	cli();
+	now = millisTimerTicks();
+	level = *p->in & p->bit;
+	if (p->limit && (now - p->armed) >= p->limit) {
+		pulseAsyncEnd(idx, 0);
+		ended = 1;
+	} else if (p->phase == PULSE_WAIT) {
+		if (level == p->stateMask) {
+			p->start = now;
+			p->phase = PULSE_IN;
+		}
+	} else if (p->phase == PULSE_IN) {
+		if (level != p->stateMask) {
+			pulseAsyncEnd(idx, now - p->start);
+			ended = 1;
+		}
+	}
+	SREG = oldSREG;
+	if (ended && p->done)
+		p->done(pulseAsyncPin(idx), millisTimerTicksToMicroseconds(p->width));
+}
+
+static void pulseAsyncEdge0(void)
+{
+	pulseAsyncEdge(EXTERNAL_INTERRUPT_0);
+}
+
+#if NUMBER_EXTERNAL_INTERRUPTS >= 2
+static void pulseAsyncEdge1(void)
+{
+	pulseAsyncEdge(EXTERNAL_INTERRUPT_1);
+}
+#endif
+
+uint8_t pulseInAsync(uint8_t pin, uint8_t state, unsigned long timeout, void (*done)(uint8_t pin, unsigned long width))
+{
+	int8_t idx = pulseAsyncIndex(pin);
+	pulseAsync_t *p;
+	uint8_t oldSREG;
+
+	if (idx < 0) return 0;
+	p = &pulseAsync[idx];
+	oldSREG = SREG;
+	cli();
+	p->in = portInputRegister(digitalPinToPort(pin));
+	p->bit = digitalPinToBitMask(pin);
+	p->stateMask = (state ? p->bit : 0);
+	p->done = done;
+	p->limit = microsecondsToMillisTimerTicks(timeout);
+	p->armed = millisTimerTicks();
+	p->width = 0;
+	// a pulse already in progress is not measured: its end is ignored in PULSE_WAIT
+	p->phase = PULSE_WAIT;
+#if NUMBER_EXTERNAL_INTERRUPTS >= 2
+	attachInterrupt(idx, idx ? pulseAsyncEdge1 : pulseAsyncEdge0, CHANGE);
+#else
+	attachInterrupt(idx, pulseAsyncEdge0, CHANGE);
+#endif
+	SREG = oldSREG;
+	return 1;
+}
+
+uint8_t pulseInAsyncReady(uint8_t pin)
+{
+	int8_t idx = pulseAsyncIndex(pin);
+	pulseAsync_t *p;
+	uint8_t oldSREG, timedOut = 0;
+
+	if (idx < 0) return 0;
+	p = &pulseAsync[idx];
+	oldSREG = SREG;
+	cli();
+	if ((p->phase == PULSE_WAIT || p->phase == PULSE_IN) && p->limit && (millisTimerTicks() - p->armed) >= p->limit) {
+		pulseAsyncEnd(idx, 0);
+		timedOut = 1;
+	}
+	SREG = oldSREG;
+	if (timedOut && p->done) p->done(pin, 0);
+	return (p->phase == PULSE_DONE);
+}
+
+unsigned long pulseInAsyncWidth(uint8_t pin)
+{
+	int8_t idx = pulseAsyncIndex(pin);
+
+	if (idx < 0 || pulseAsync[idx].phase != PULSE_DONE) return 0;
+	pulseAsync[idx].phase = PULSE_IDLE;
+	return millisTimerTicksToMicroseconds(pulseAsync[idx].width);
+}
+
+void pulseInAsyncCancel(uint8_t pin)
+{
+	int8_t idx = pulseAsyncIndex(pin);
+
+	if (idx < 0) return;
+	detachInterrupt(idx);
+	pulseAsync[idx].phase = PULSE_IDLE;
+}
+
+void pulseInAsyncPoll(void)
+{
+	uint8_t idx;
+
+	for (idx = 0; idx < NUMBER_EXTERNAL_INTERRUPTS; idx++) {
+		if (pulseAsync[idx].phase == PULSE_WAIT || pulseAsync[idx].phase == PULSE_IN)
+			pulseInAsyncReady(pulseAsyncPin(idx));
+	}
+}
+
+#endif
@@ -0,0 +1,127 @@
+/*
+  wiring_scheduler.c - cooperative task scheduler for sketches with a
+  polled service (the usbPoll() of the V-USB libraries)
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General
+  Public License along with this library; if not, write to the
+  Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+  Boston, MA  02111-1307  USA
+*/
+
+#include "wiring_private.h"
+
+/* A pass of schedulerRun() calls the service, then the tasks that are due, in
+ * turn, as long as the budget of the next one fits into what is left of the
+ * service interval.  So the service is never late if the budgets hold, and a
+ * task that did not fit is first in line after the next service call.  With a
+ * frame counter a task pass starts at most once per frame, right after the
+ * service saw the counter change; in between the service runs on its own. */
+
+typedef struct {
+	void (*task)(void);
+	uint16_t periodMs;
+	uint16_t budgetUs;
+	uint16_t lastMs;
+} schedulerSlot_t;
+
+static schedulerSlot_t slots[SCHEDULER_TASKS];
+static void (*service)(void);
+static uint16_t serviceIntervalUs;
+static volatile uint8_t *frameCounter;
+static uint8_t lastFrame;
+static uint8_t nextSlot;
+static uint8_t running;
+
+void schedulerSetService(void (*poll)(void), uint16_t intervalUs)
+{
+	service = poll;
+	serviceIntervalUs = intervalUs;
+}
+
+void schedulerSetFrameCounter(volatile uint8_t *counter)
+{
+	frameCounter = counter;
+	if (counter)
+		lastFrame = *counter;
+}
+
+uint8_t schedulerAdd(void (*task)(void), uint16_t periodMs, uint16_t budgetUs)
+{
+	uint8_t i;
+
+	if (service && budgetUs > serviceIntervalUs)
+		return SCHEDULER_NONE;
+	for (i = 0; i < SCHEDULER_TASKS; i++) {
+		if (!slots[i].task) {
+			slots[i].periodMs = periodMs;
+			slots[i].budgetUs = budgetUs;
+			slots[i].lastMs = (uint16_t)millis() - periodMs;	// due at once
+			slots[i].task = task;
+			return i;
+		}
+	}
+	return SCHEDULER_NONE;
+}
+
+void schedulerRemove(uint8_t slot)
+{
+	if (slot < SCHEDULER_TASKS)
+		slots[slot].task = 0;
+}
+
+void schedulerRun(void)
+{
+	uint16_t start;
+	uint8_t n;
+
+	start = (uint16_t)micros();
+	if (service)
+		service();
+
+	// a task calling delay() of a USB library gets the service only
+	if (running)
+		return;
+	if (frameCounter) {
+		uint8_t frame = *frameCounter;
+		if (frame == lastFrame)
+			return;
+		lastFrame = frame;
+	}
+
+	running = 1;
+	for (n = SCHEDULER_TASKS; n; n--) {
+		schedulerSlot_t *s = &slots[nextSlot];
+		uint16_t now = (uint16_t)millis();
+
+		if (s->task && (uint16_t)(now - s->lastMs) >= s->periodMs) {
+			if (service && (uint32_t)(uint16_t)((uint16_t)micros() - start) + s->budgetUs > serviceIntervalUs)
+				break;	// would make the service late: first in line next pass
+			s->lastMs += s->periodMs;
+			if ((uint16_t)(now - s->lastMs) >= s->periodMs)
+				s->lastMs = now;	// too far behind to catch up
+			s->task();
+		}
+		if (++nextSlot == SCHEDULER_TASKS)
+			nextSlot = 0;
+	}
+	running = 0;
+}
+
+void schedulerDelay(unsigned long ms)
+{
+	unsigned long start = millis();
+
+	do {
+		schedulerRun();
+	} while (millis() - start < ms);
+}
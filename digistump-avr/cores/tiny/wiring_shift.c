@@ -22,12 +22,31 @@
   $Id: wiring.c 248 2007-02-03 15:36:30Z mellis $
 */
 
+#include "core_pins.h"
+#include "core_usi.h"
 #include "wiring_private.h"
 
+#if defined( USICR ) && defined( USI_PORT ) && defined( CORE_USI_SCK_PIN )
+/* On the USI pins (DI/DO and USCK), the byte is shifted by the USI at F_CPU/2
+ * instead of 8 digitalWrite()/digitalRead() pairs. */
+#define SHIFT_WITH_USI
+#endif
+
 uint8_t shiftIn(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder) {
 	uint8_t value = 0;
 	uint8_t i;
 
+#ifdef SHIFT_WITH_USI
+	// the USI would drive DO as well: only if it is an input
+	if (dataPin == CORE_USI_DI_PIN && clockPin == CORE_USI_SCK_PIN && !(USI_DDR & _BV(USI_DO_BIT))) {
+		USI_PORT &= ~_BV(USI_SCK_BIT);
+		USI_ThreeWireEnable();
+		value = USI_TransferFast(0);
+		USI_Disable();
+		return (bitOrder == LSBFIRST) ? USI_ReverseBits(value) : value;
+	}
+#endif
+
 	for (i = 0; i < 8; ++i) {
 		digitalWrite(clockPin, HIGH);
 		if (bitOrder == LSBFIRST)
@@ -43,6 +62,16 @@ void shiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t val)
 {
 	uint8_t i;
 
+#ifdef SHIFT_WITH_USI
+	if (dataPin == CORE_USI_DO_PIN && clockPin == CORE_USI_SCK_PIN) {
+		USI_PORT &= ~_BV(USI_SCK_BIT);
+		USI_ThreeWireEnable();
+		USI_TransferFast((bitOrder == LSBFIRST) ? USI_ReverseBits(val) : val);
+		USI_Disable();
+		return;
+	}
+#endif
+
 	for (i = 0; i < 8; i++)  {
 		if (bitOrder == LSBFIRST)
 			digitalWrite(dataPin, !!(val & (1 << i)));
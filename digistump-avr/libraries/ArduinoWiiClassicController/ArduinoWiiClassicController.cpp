@@ -22,21 +22,77 @@ void ArduinoWiiClassicController::init()
   ArduinoWiiClassicController::_sendByte(0x55, 0xF0);
   ArduinoWiiClassicController::_sendByte(0x00, 0xFB);
 
+  ArduinoWiiClassicController::_request();
+  delayMicroseconds(WII_CLASSIC_CONVERSION_US);
   ArduinoWiiClassicController::update();
 }
 
-void ArduinoWiiClassicController::update()
+/*
+ * The conversion of the next values is requested right after each read, so
+ * they are ready on the following call instead of waiting for them here.
+ */
+boolean ArduinoWiiClassicController::update()
+{
+  if ((micros() - _requestUs) < WII_CLASSIC_CONVERSION_US)
+  {
+    return false;
+  }
+
+  boolean ok = ArduinoWiiClassicController::_read();
+
+  ArduinoWiiClassicController::_request();
+  if (ok)
+  {
+    ArduinoWiiClassicController::_decode();
+  }
+  return ok;
+}
+
+/*
+ * For a reader on a fixed schedule (e.g. DigiJoystick.bridge()): the values
+ * are converted now, not at the previous call.
+ */
+boolean ArduinoWiiClassicController::readNow()
 {
-  int count = 0;
-  int values[6];
+  ArduinoWiiClassicController::_request();
+  delayMicroseconds(WII_CLASSIC_CONVERSION_US);
+
+  boolean ok = ArduinoWiiClassicController::_read();
 
-  //Read data
-  TinyWireM.requestFrom(ADDRESS, 6);
-  while(TinyWireM.available())
+  ArduinoWiiClassicController::_request();
+  if (ok)
   {
-    values[count] = TinyWireM.receive();
-    count++;
+    ArduinoWiiClassicController::_decode();
   }
+  return ok;
+}
+
+boolean ArduinoWiiClassicController::_read()
+{
+  // Bus error: the previous values are kept
+  if (TinyWireM.requestFrom(ADDRESS, 6))
+  {
+    return false;
+  }
+  for (byte i = 0; i < 6; i++)
+  {
+    _raw[i] = TinyWireM.receive();
+  }
+  return true;
+}
+
+void ArduinoWiiClassicController::_request()
+{
+  TinyWireM.beginTransmission(ADDRESS);
+  TinyWireM.send(0x00);
+  TinyWireM.endTransmission();
+
+  _requestUs = micros();
+}
+
+void ArduinoWiiClassicController::_decode()
+{
+  byte *values = _raw;
 
   //Left Analog Stick
   ArduinoWiiClassicController::leftAnalogX = values[0] & 63;
@@ -78,8 +134,6 @@ void ArduinoWiiClassicController::update()
   ArduinoWiiClassicController::aButton = !((values[5] >> 4) & 1);
   ArduinoWiiClassicController::xButton = !((values[5] >> 3) & 1);
   ArduinoWiiClassicController::zRightButton = !((values[5] >> 2) & 1);
-
-  ArduinoWiiClassicController::_sendByte(0x00, 0x00);
 }
 
 void ArduinoWiiClassicController::_sendByte(byte data, byte location)
@@ -14,6 +14,9 @@
 
 #include <Arduino.h>
 
+// Time the controller needs between the conversion request and the read of its result
+#define WII_CLASSIC_CONVERSION_US 1000
+
 class ArduinoWiiClassicController
 {
   public:
@@ -43,10 +46,17 @@ class ArduinoWiiClassicController
     int zRightButton;
 
     void init();
-    void update();
+    boolean update(); // Never waits: true if new values were read
+    boolean readNow(); // Fresh values: waits for a conversion (about 1.7 ms)
 
   private:
+    byte _raw[6];
+    unsigned long _requestUs;
+
     void _sendByte(byte data, byte location);
+    void _request();
+    boolean _read();
+    void _decode();
 };
 
 #endif
@@ -5,27 +5,32 @@
 #include <DigiJoystick.h>
 #include <ArduinoWiiClassicController.h>
 
-ArduinoWiiClassicController classic = ArduinoWiiClassicController(); 
+// buildReport() fills the default report layout of usbconfig.h:
+// 6 axes of 8 bits and 16 buttons, 8 bytes
+#if DIGIJOYSTICK_AXES != 6 || DIGIJOYSTICK_AXIS_BITS != 8 || DIGIJOYSTICK_HAT || DIGIJOYSTICK_BUTTONS != 16
+#error "This example needs the default DigiJoystick report layout"
+#endif
 
-void setup() {
-  classic.init();
-}
+ArduinoWiiClassicController classic = ArduinoWiiClassicController(); 
 
+/*
+ * Called by DigiJoystick right before the host polls the joystick: the
+ * controller is read at that time, so the report is never a poll late.
+ */
+void buildReport(unsigned char *report) {
+  classic.readNow();
 
-void loop() {
-  classic.update();
-  
   //Left Stick
-  DigiJoystick.setX(byte(map(classic.rightAnalogX,0,32,0,255)));
-  DigiJoystick.setY(byte(map(classic.rightAnalogY,0,32,255,0))); //Invert Y axis. Check on Windows    
+  report[0] = byte(map(classic.rightAnalogX,0,32,0,255)); //X
+  report[1] = byte(map(classic.rightAnalogY,0,32,255,0)); //Y: Invert Y axis. Check on Windows
 
   //Right Stick
-  DigiJoystick.setXROT(byte(map(classic.leftAnalogX,0,64,0,255)));
-  DigiJoystick.setYROT(byte(map(classic.leftAnalogY,0,64,255,0))); //Invert Y axis. Check on Windows
+  report[2] = byte(map(classic.leftAnalogX,0,64,0,255)); //XROT
+  report[3] = byte(map(classic.leftAnalogY,0,64,255,0)); //YROT: Invert Y axis. Check on Windows
 
   //Analog buttons
-  DigiJoystick.setZROT(byte(map(classic.rightTriggerButton,0,32,0,255)));
-  DigiJoystick.setSLIDER(byte(map(classic.leftTriggerButton,0,32,0,255)));
+  report[4] = byte(map(classic.rightTriggerButton,0,32,0,255)); //ZROT
+  report[5] = byte(map(classic.leftTriggerButton,0,32,0,255)); //SLIDER
   
   byte buttonLSB = 0;
   bitWrite(buttonLSB, 0, classic.rightTriggerButton);
@@ -47,6 +52,16 @@ void loop() {
   bitWrite(buttonMSB, 6, classic.zRightButton);
   bitWrite(buttonMSB, 7, 0);
   
-  DigiJoystick.setButtons(buttonLSB,buttonMSB);
-  DigiJoystick.delay(10);
+  report[6] = buttonLSB;
+  report[7] = buttonMSB;
+}
+
+void setup() {
+  classic.init();
+  DigiJoystick.bridge(buildReport);
+}
+
+
+void loop() {
+  DigiJoystick.update();
 }
@@ -20,14 +20,15 @@ static uchar       portB_dtr_bit;
 
 DigiCDCDevice::DigiCDCDevice(void){}
 
+static void digiCDCService(void)
+{
+  SerialUSB.refresh();
+}
 
+// refreshes in the background and runs the schedulerAdd() tasks
 void DigiCDCDevice::delay(long milli) {
-  unsigned long last = millis();
-  while (milli > 0) {
-    unsigned long now = millis();
-    milli -= now - last;
-    last = now;
-    refresh();
+  if (milli > 0) {
+    schedulerDelay(milli);
   }
 }
 
@@ -105,7 +106,6 @@ void DigiCDCDevice::task(void)
 
 void DigiCDCDevice::refresh(void)
 {    
-  _delay_ms(1);
   usbPollWrapper();
 }
 
@@ -147,6 +147,8 @@ void DigiCDCDevice::usbBegin()
     sendEmptyFrame = 0;
     portB_dtr_bit = 255;
     sei();   
+
+    schedulerSetService(digiCDCService, SCHEDULER_USB_INTERVAL_US);
 }
 
 void DigiCDCDevice::usbPollWrapper()
@@ -176,8 +176,22 @@ section at the end of this file).
  * usbFunctionWrite(). Use the global usbCurrentDataToken and a static variable
  * for each control- and out-endpoint to check for duplicate packets.
  */
+#define USB_CFG_HAVE_STATS              0
+/* define this macro to 1 to count packets, CRC errors, NAKed interrupt-in
+ * polls, bus resets and the longest interrupt latency in the global usbStats
+ * (see usbdrv.h). The host reads them with the vendor request below, which
+ * the driver answers itself. Costs about 16 bytes of RAM.
+ */
+#define USB_CFG_STATS_REQUEST           0x53
+/* bRequest of the vendor IN request that reads usbStats. Must not be used by
+ * usbFunctionSetup().
+ */
 
 #define USB_CFG_HAVE_MEASURE_FRAME_LENGTH   1
+#define USB_CFG_OSCCAL_TRACKING             1
+/* define this macro to 1 to keep OSCCAL calibrated while the device runs,
+ * see osccal.h. Each measurement disables interrupts for one frame (1 ms).
+ */
 #include "osccal.h"
 
 /* define this macro to 1 if you want the function usbMeasureFrameLength()
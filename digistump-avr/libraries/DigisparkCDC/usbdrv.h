@@ -414,6 +414,30 @@ extern volatile schar   usbRxLen;
  * first.
  */
 
+#if USB_CFG_HAVE_STATS
+typedef struct usbStats{
+    unsigned    rxPackets;      /* data packets received: SETUP and OUT */
+    unsigned    txPackets;      /* data packets prepared for endpoint 0 and interrupt-in */
+    unsigned    crcErrors;      /* data packets dropped by USB_CFG_CHECK_CRC */
+    unsigned    intrNaks;       /* interrupt-in polls answered with NAK (or STALL) */
+    unsigned    resets;         /* bus resets */
+    unsigned    maxIrqLatency;  /* longest interrupts-disabled window in us */
+}usbStats_t;
+extern usbStats_t   usbStats;
+/* Counters of the driver, compiled in with USB_CFG_HAVE_STATS. They wrap
+ * around at 65536, so the host should compare two reads. The host reads the
+ * 12 bytes (little endian) with the vendor IN request USB_CFG_STATS_REQUEST,
+ * which the driver answers itself: usbFunctionSetup() is not called for it.
+ * maxIrqLatency is the value of maxInterruptLatency() of the core, which is
+ * reset by each read and stays 0 unless the core is built with
+ * MILLIS_TIMER_LATENCY 1. It includes the USB interrupt itself, which may take up
+ * to about 80 us for a data packet and its handshake. Longer windows come from
+ * other code that disables interrupts and may cost lost packets.
+ * intrNaks is only counted at 15 MHz and above, since the count adds a few
+ * cycles to the handshake response.
+ */
+#endif
+
 #endif  /* __ASSEMBLER__ */
 
 
@@ -602,6 +626,15 @@ int usbDescriptorStringSerialNumber[];
 #define USB_CFG_HAVE_INTRIN_ENDPOINT3   0
 #endif
 
+#ifndef USB_CFG_HAVE_STATS
+#define USB_CFG_HAVE_STATS      0
+#endif
+#ifndef USB_CFG_STATS_REQUEST
+#define USB_CFG_STATS_REQUEST   0x53
+#endif
+/* the NAK count needs 5 cycles before the handshake is sent */
+#define USB_STATS_COUNT_NAKS    (USB_CFG_HAVE_STATS && USB_CFG_CLOCK_KHZ >= 15000)
+
 #define USB_BUFSIZE     11  /* PID, 8 bytes data, 2 bytes CRC */
 
 /* ------------------------------------------------------------------------- */
@@ -10,8 +10,6 @@
 #ifndef __DigiJoystick_h__
 #define __DigiJoystick_h__
  
-#define GCN64_REPORT_SIZE 8
-
 #include <Arduino.h>
 #include <avr/pgmspace.h>
 #include <avr/interrupt.h>
@@ -26,6 +24,14 @@
 #include "oddebug.h"
 #include "usbconfig.h"
  
+// The report layout is configured by DIGIJOYSTICK_AXES, DIGIJOYSTICK_AXIS_BITS,
+// DIGIJOYSTICK_HAT and DIGIJOYSTICK_BUTTONS in usbconfig.h
+#define GCN64_REPORT_SIZE DIGIJOYSTICK_REPORT_SIZE
+#define DIGIJOYSTICK_AXIS_MAX ((1UL << DIGIJOYSTICK_AXIS_BITS) - 1)
+#define DIGIJOYSTICK_HAT_POS (DIGIJOYSTICK_AXES * DIGIJOYSTICK_AXIS_BITS)
+#define DIGIJOYSTICK_BUTTONS_POS (DIGIJOYSTICK_HAT_POS + DIGIJOYSTICK_HAT * 4)
+#define DIGIJOYSTICK_HAT_CENTERED 8
+
 const static uchar *rt_usbHidReportDescriptor=NULL;
 static uchar rt_usbHidReportDescriptorSize=0;
 const static uchar *rt_usbDeviceDescriptor=NULL;
@@ -40,8 +46,8 @@ static uchar rt_usbDeviceDescriptorSize=0;
 /* What was most recently read from the controller */
 unsigned char last_built_report[GCN64_REPORT_SIZE];
 
-/* What was most recently sent to the host */
-unsigned char last_sent_report[GCN64_REPORT_SIZE];
+/* Set when last_built_report changed since it was last sent to the host */
+static unsigned char report_dirty = 0;
 
 uchar		 reportBuffer[8];
 
@@ -52,7 +58,19 @@ static unsigned char idle_rate = DIGIJOYSTICK_DEFAULT_REPORT_INTERVAL / 4; // in
 // new minimum report frequency system:
 static unsigned long last_report_time = 0;
 
+// bridge mode: the report is built by a source function right before the next
+// interrupt-IN poll of the host, instead of whenever the sketch gets to it
+#define DIGIJOYSTICK_BRIDGE_LEAD_US 2500
+typedef void (*DigiJoystickSource)(unsigned char *report);
+static DigiJoystickSource bridge_source = NULL;
+static unsigned int bridge_lead_us = DIGIJOYSTICK_BRIDGE_LEAD_US;
+static unsigned long bridge_poll_us = 0; // when the host took the last report
+static unsigned long bridge_period_us = USB_CFG_INTR_POLL_INTERVAL * 1000UL; // measured
+static unsigned char bridge_pending = 0;
+
 
+// Built from the configuration in usbconfig.h, USB_CFG_HID_REPORT_DESCRIPTOR_LENGTH
+// there must follow any change here
 const unsigned char gcn64_usbHidReportDescriptor[] PROGMEM = {
 		0x05, 0x01,										 // USAGE_PAGE (Generic Desktop)
 		0x09, 0x05,										 // USAGE (Gamepad)
@@ -62,29 +80,69 @@ const unsigned char gcn64_usbHidReportDescriptor[] PROGMEM = {
 	0xa1, 0x00,										 //		COLLECTION (Physical)
 	0x05, 0x01,										 //			USAGE_PAGE (Generic Desktop)
 		0x09, 0x30,										 //			USAGE (X)
+#if DIGIJOYSTICK_AXES > 1
 		0x09, 0x31,										 //			USAGE (Y)
-	
+#endif
+#if DIGIJOYSTICK_AXES > 2
 	0x09, 0x33,						 //			USAGE (Rx)
+#endif
+#if DIGIJOYSTICK_AXES > 3
 	0x09, 0x34,						//		USAGE (Ry)
-
+#endif
+#if DIGIJOYSTICK_AXES > 4
 	0x09, 0x35,						//		USAGE (Rz)	
+#endif
+#if DIGIJOYSTICK_AXES > 5
 	0x09, 0x36,						//		USAGE (Slider)	
+#endif
+#if DIGIJOYSTICK_AXES > 6
+	0x09, 0x32,						//		USAGE (Z)
+#endif
+#if DIGIJOYSTICK_AXES > 7
+	0x09, 0x37,						//		USAGE (Dial)
+#endif
 
 		0x15, 0x00,										 //			LOGICAL_MINIMUM (0)
-		0x26, 0xFF, 0x00,							 //			LOGICAL_MAXIMUM (255)
-		0x75, 0x08,										 //			REPORT_SIZE (8)
-		0x95, 0x06,										 //			REPORT_COUNT (6)
+#if DIGIJOYSTICK_AXIS_BITS < 16
+		0x26, (unsigned char)DIGIJOYSTICK_AXIS_MAX, (unsigned char)(DIGIJOYSTICK_AXIS_MAX >> 8), //	LOGICAL_MAXIMUM (DIGIJOYSTICK_AXIS_MAX)
+#else
+		0x27, 0xFF, 0xFF, 0x00, 0x00,				 //			LOGICAL_MAXIMUM (65535)
+#endif
+		0x75, DIGIJOYSTICK_AXIS_BITS,				 //			REPORT_SIZE (DIGIJOYSTICK_AXIS_BITS)
+		0x95, DIGIJOYSTICK_AXES,					 //			REPORT_COUNT (DIGIJOYSTICK_AXES)
 		0x81, 0x02,										 //			INPUT (Data,Var,Abs)
 	0xc0,													 //		END_COLLECTION (Physical)
 
+#if DIGIJOYSTICK_HAT
+		0x09, 0x39,										 //		USAGE (Hat switch)
+		0x15, 0x00,										 //		LOGICAL_MINIMUM (0)
+		0x25, 0x07,										 //		LOGICAL_MAXIMUM (7)
+		0x35, 0x00,										 //		PHYSICAL_MINIMUM (0)
+		0x46, 0x3B, 0x01,							 //		PHYSICAL_MAXIMUM (315)
+		0x65, 0x14,										 //		UNIT (Eng Rot:Angular Pos)
+		0x75, 0x04,										 //		REPORT_SIZE (4)
+		0x95, 0x01,										 //		REPORT_COUNT (1)
+		0x81, 0x42,										 //		INPUT (Data,Var,Abs,Null)
+		0x65, 0x00,										 //		UNIT (None)
+		0x45, 0x00,										 //		PHYSICAL_MAXIMUM (0)
+#endif
+
+#if DIGIJOYSTICK_BUTTONS
 		0x05, 0x09,										 //		USAGE_PAGE (Button)
 		0x19, 0x01,										 //		USAGE_MINIMUM (Button 1)
-		0x29, 0x10,										 //		USAGE_MAXIMUM (Button 14)
+		0x29, DIGIJOYSTICK_BUTTONS,				 //		USAGE_MAXIMUM (Button DIGIJOYSTICK_BUTTONS)
 		0x15, 0x00,										 //		LOGICAL_MINIMUM (0)
 		0x25, 0x01,										 //		LOGICAL_MAXIMUM (1)
 		0x75, 0x01,										 //		REPORT_SIZE (1)
-		0x95, 0x10,										 //		REPORT_COUNT (16)
+		0x95, DIGIJOYSTICK_BUTTONS,				 //		REPORT_COUNT (DIGIJOYSTICK_BUTTONS)
 		0x81, 0x02,										 //		INPUT (Data,Var,Abs)
+#endif
+
+#if DIGIJOYSTICK_PADDING_BITS
+		0x75, DIGIJOYSTICK_PADDING_BITS,			 //		REPORT_SIZE (DIGIJOYSTICK_PADDING_BITS)
+		0x95, 0x01,										 //		REPORT_COUNT (1)
+		0x81, 0x03,										 //		INPUT (Cnst,Var,Abs)
+#endif
 
 		0xc0													 // END_COLLECTION (Application)
 };
@@ -127,7 +185,30 @@ void gamecubeBuildReport(unsigned char *reportBuf) {
 		memcpy(reportBuf, last_built_report, GCN64_REPORT_SIZE);
 	}
 	
-	memcpy(last_sent_report, last_built_report, GCN64_REPORT_SIZE); 
+	report_dirty = 0;
+}
+
+// Store the 'bits' low bits of 'value' at bit 'pos' of the report (HID order: LSB
+// first), returns 1 if the report changed
+unsigned char digiJoystickSetBits(unsigned char pos, unsigned char bits, unsigned long value) {
+	unsigned char changed = 0;
+	
+	while (bits) {
+		unsigned char *p = &last_built_report[pos >> 3];
+		unsigned char shift = pos & 7;
+		unsigned char n = 8 - shift;
+		if (n > bits) {
+			n = bits;
+		}
+		unsigned char mask = ((1 << n) - 1) << shift;
+		unsigned char b = (*p & ~mask) | (((unsigned char)value << shift) & mask);
+		changed |= b ^ *p;
+		*p = b;
+		value >>= n;
+		pos += n;
+		bits -= n;
+	}
+	return changed != 0;
 }
 
 int getGamepadReport(unsigned char *dstbuf) {
@@ -136,6 +217,8 @@ int getGamepadReport(unsigned char *dstbuf) {
 }
 
  
+static void digiJoystickService(void);
+
 class DigiJoystickDevice {
  public:
 	DigiJoystickDevice () {
@@ -153,12 +236,20 @@ class DigiJoystickDevice {
 		
 		sei();
 		
+		setHat(DIGIJOYSTICK_HAT_CENTERED);
+		report_dirty = 0;
 		last_report_time = millis();
+		schedulerSetService(digiJoystickService, SCHEDULER_USB_INTERVAL_US);
 	}
 	
 	void update() {
 		usbPoll();
 		
+		if (bridge_source) {
+			bridgeUpdate();
+			return;
+		}
+		
 		// instead of above code, use millis arduino system to enforce minimum reporting frequency
 		unsigned long time_since_last_report = millis() - last_report_time;
 		/* idle_rate == 0, never send idle reports
@@ -171,7 +262,7 @@ class DigiJoystickDevice {
 		}
 		
 		// if the report has changed, try force an update anyway
-		if (memcmp(last_built_report, last_sent_report, GCN64_REPORT_SIZE)) {
+		if (report_dirty) {
 			must_report = 1;
 		}
 	
@@ -186,39 +277,99 @@ class DigiJoystickDevice {
 		}
 	}
 	
+	// Bridge mode: 'source' writes the DIGIJOYSTICK_REPORT_SIZE report bytes (with the
+	// default configuration X, Y, XROT, YROT, ZROT, SLIDER, buttons low, buttons high)
+	// 'leadUs' before each poll of the host, so the report
+	// is at most 'leadUs' old when the host takes it. NULL: back to the setX()... mode.
+	// The sketch then only has to call update() or delay() often (every ms or so).
+	void bridge(DigiJoystickSource source, unsigned int leadUs = DIGIJOYSTICK_BRIDGE_LEAD_US) {
+		bridge_source = source;
+		bridge_lead_us = leadUs;
+		bridge_poll_us = micros();
+		bridge_pending = 0;
+	}
+	
+	void bridgeUpdate() {
+		unsigned long now = micros();
+		
+		if (bridge_pending) {
+			if (!usbInterruptIsReady()) {
+				return; // not taken yet
+			}
+			// the host has just taken the report: this is a poll slot
+			unsigned long period = now - bridge_poll_us;
+			// a missed slot (about twice the period) says nothing about the interval
+			if (period > bridge_period_us / 2 && period < bridge_period_us + bridge_period_us / 2) {
+				bridge_period_us += ((long)period - (long)bridge_period_us) / 4;
+			}
+			bridge_poll_us = now;
+			bridge_pending = 0;
+		}
+		
+		if ((now - bridge_poll_us) + bridge_lead_us >= bridge_period_us) {
+			bridge_source(last_built_report);
+			gamecubeBuildReport(reportBuffer);
+			usbSetInterrupt(reportBuffer, GCN64_REPORT_SIZE);
+			bridge_pending = 1;
+		}
+	}
+	
 	// delay while updating until we are finished delaying
 	void delay(long milli) {
-		unsigned long last = millis();
-	  while (milli > 0) {
-	    unsigned long now = millis();
-	    milli -= now - last;
-	    last = now;
-	    update();
-	  }
+		if (milli > 0) {
+			schedulerDelay(milli); // update() and the schedulerAdd() tasks
+		}
+	}
+	
+	// Axis 'index' (0 X, 1 Y, 2 XROT, 3 YROT, 4 ZROT, 5 SLIDER, 6 Z, 7 DIAL) to 'value',
+	// 0 to DIGIJOYSTICK_AXIS_MAX
+	void setAxis(unsigned char index, unsigned int value) {
+		if (index >= DIGIJOYSTICK_AXES) {
+			return;
+		}
+#if DIGIJOYSTICK_AXIS_BITS == 8
+		if (last_built_report[index] != (unsigned char)value) {
+			last_built_report[index] = value;
+			report_dirty = 1;
+		}
+#else
+		if (digiJoystickSetBits(index * DIGIJOYSTICK_AXIS_BITS, DIGIJOYSTICK_AXIS_BITS, value)) {
+			report_dirty = 1;
+		}
+#endif
+	}
+	
+	// 0 to 255 over the full range of the axis
+	void setAxis8(unsigned char index, byte value) {
+#if DIGIJOYSTICK_AXIS_BITS == 8
+		setAxis(index, value);
+#else
+		setAxis(index, (((unsigned int)value << 8) | value) >> (16 - DIGIJOYSTICK_AXIS_BITS));
+#endif
 	}
 	
 	void setX(byte value) {
-		last_built_report[0] = value;
+		setAxis8(0, value);
 	}
 	
 	void setY(byte value) {
-		last_built_report[1] = value;
+		setAxis8(1, value);
 	}
 	
 	void setXROT(byte value) {
-		last_built_report[2] = value;
+		setAxis8(2, value);
 	}
 	
 	void setYROT(byte value) {
-		last_built_report[3] = value;
+		setAxis8(3, value);
 	}
 	
 	void setZROT(byte value) {
-		last_built_report[4] = value;
+		setAxis8(4, value);
 	}
 	
 	void setSLIDER(byte value) {
-		last_built_report[5] = value;
+		setAxis8(5, value);
 	}
 	
 	void setX(char value) {
@@ -244,28 +395,63 @@ class DigiJoystickDevice {
 		setSLIDER(*(reinterpret_cast<byte *>(&value)));
 	}
 	
+	// 0 up, 1 up right ... 7 up left clockwise, DIGIJOYSTICK_HAT_CENTERED (or more) centered
+	void setHat(unsigned char direction) {
+#if DIGIJOYSTICK_HAT
+		if (direction > DIGIJOYSTICK_HAT_CENTERED) {
+			direction = DIGIJOYSTICK_HAT_CENTERED;
+		}
+		if (digiJoystickSetBits(DIGIJOYSTICK_HAT_POS, 4, direction)) {
+			report_dirty = 1;
+		}
+#endif
+	}
+	
+	// Button 'index' (0 is button 1) pressed or not
+	void setButton(unsigned char index, bool pressed) {
+		if (index < DIGIJOYSTICK_BUTTONS && digiJoystickSetBits(DIGIJOYSTICK_BUTTONS_POS + index, 1, pressed)) {
+			report_dirty = 1;
+		}
+	}
+	
+	// All buttons at once, bit 0 is button 1
+	void setButtons(unsigned long buttons) {
+#if DIGIJOYSTICK_BUTTONS
+		if (digiJoystickSetBits(DIGIJOYSTICK_BUTTONS_POS, DIGIJOYSTICK_BUTTONS, buttons)) {
+			report_dirty = 1;
+		}
+#endif
+	}
+	
+	// Buttons 1 to 8 and 9 to 16
 	void setButtons(unsigned char low, unsigned char high) {
-		last_built_report[6] = low;
-		last_built_report[7] = high;
+		setButtons(((unsigned long)high << 8) | low);
 	}
 	
 	void setButtons(char low,char high) {
 		setButtons(*reinterpret_cast<unsigned char *>(&low),*reinterpret_cast<unsigned char *>(&high));
 	}
 	
+	// The raw report, DIGIJOYSTICK_REPORT_SIZE bytes
 	void setValues(unsigned char values[]) {
-		memcpy(last_built_report, values, GCN64_REPORT_SIZE);
+		if (memcmp(last_built_report, values, GCN64_REPORT_SIZE)) {
+			memcpy(last_built_report, values, GCN64_REPORT_SIZE);
+			report_dirty = 1;
+		}
 	}
 	
 	void setValues(char values[]) {
-		unsigned char *foo = reinterpret_cast<unsigned char *>(values);//preserves bit values in cast
-		memcpy(last_built_report, foo, GCN64_REPORT_SIZE);
+		setValues(reinterpret_cast<unsigned char *>(values));//preserves bit values in cast
 	}
 };
 
 // Create global singleton object for users to make use of
 DigiJoystickDevice DigiJoystick = DigiJoystickDevice();
 
+static void digiJoystickService(void) {
+	DigiJoystick.update();
+}
+
 
 
 
@@ -0,0 +1,41 @@
+// DigiJoystick with high resolution axes and a hat switch
+//
+// The report is configured in usbconfig.h of the library, for this sketch:
+//   #define DIGIJOYSTICK_AXES               4
+//   #define DIGIJOYSTICK_AXIS_BITS          10
+//   #define DIGIJOYSTICK_HAT                1
+//   #define DIGIJOYSTICK_BUTTONS            8
+// 4 * 10 + 4 + 8 bits fit in 7 bytes (a low speed report holds 8 at most).
+// With other settings the sketch still works, missing axes and buttons are ignored.
+
+#include "DigiJoystick.h"
+
+void setup() {
+  pinMode(0, INPUT_PULLUP); // trigger
+}
+
+void loop() {
+  // stick from the two ADC inputs left by USB (P3 and P4 are D- and D+),
+  // 0 to 1023. P5 is also the reset pin: wire its pot so that it stays above
+  // half the supply (e.g. in series with a resistor of the same value to 5V),
+  // the axis then covers 512 to 1023.
+  unsigned int x = analogRead(1);        // ADC1, P2
+  unsigned int y = analogRead(0);        // ADC0, P5
+
+  y = y < 512 ? 0 : (y - 512) * 2;
+
+  // scale the 10 bit readings to the configured axis range, the other axes
+  // (throttle...) stay at 0: no ADC input is left for them
+  DigiJoystick.setAxis(0, (unsigned long)x * DIGIJOYSTICK_AXIS_MAX / 1023);
+  DigiJoystick.setAxis(1, (unsigned long)y * DIGIJOYSTICK_AXIS_MAX / 1023);
+
+  // the hat turns once around every 8 seconds, centered in between
+  unsigned char step = (millis() / 500) % 16;
+  DigiJoystick.setHat(step < 8 ? step : DIGIJOYSTICK_HAT_CENTERED);
+
+  DigiJoystick.setButton(0, digitalRead(0) == LOW);
+
+  // a report is only queued when a value changed (or the host asked for idle
+  // reports), so calling this often costs little
+  DigiJoystick.delay(5);
+}
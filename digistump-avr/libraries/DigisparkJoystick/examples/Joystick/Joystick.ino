@@ -13,6 +13,9 @@ void loop() {
   // calling more often than that is fine
   // this will actually only send the data every once in a while unless the data is different
   
+  // the report (axes, resolution, hat, buttons) is configured in usbconfig.h, the
+  // byte array and setX()... below are for the default of 6 axes and 16 buttons
+  
   // you can set the values from a raw byte array with:
   // char myBuf[8] = {
   //   x, y, xrot, yrot, zrot, slider,
@@ -35,4 +38,6 @@ void loop() {
   
   // we can also set buttons like this (lowByte, highByte)
   //DigiJoystick.setButtons(0x00, 0x00);
+  // or one at a time (0 is button 1)
+  //DigiJoystick.setButton(0, true);
 }
\ No newline at end of file
@@ -79,7 +79,12 @@ section at the end of this file).
 /* If you compile a version with endpoint 1 (interrupt-in), this is the poll
  * interval. The value is in milliseconds and must not be less than 10 ms for
  * low speed devices.
+ * 10 is the minimum the USB specification allows for low speed. Most hosts
+ * round it down to a power of two, so 10 to 15 result in a poll every 8 ms.
  */
+#if USB_CFG_INTR_POLL_INTERVAL < 10 || USB_CFG_INTR_POLL_INTERVAL > 255
+#error "USB_CFG_INTR_POLL_INTERVAL must be 10 to 255 ms for a low speed device"
+#endif
 #define USB_CFG_IS_SELF_POWERED         0
 /* Define this to 1 if the device has its own power supply. Set it to 0 if the
  * device is powered from the USB bus.
@@ -164,7 +169,21 @@ section at the end of this file).
  * usbFunctionWrite(). Use the global usbCurrentDataToken and a static variable
  * for each control- and out-endpoint to check for duplicate packets.
  */
+#define USB_CFG_HAVE_STATS              0
+/* define this macro to 1 to count packets, CRC errors, NAKed interrupt-in
+ * polls, bus resets and the longest interrupt latency in the global usbStats
+ * (see usbdrv.h). The host reads them with the vendor request below, which
+ * the driver answers itself. Costs about 16 bytes of RAM.
+ */
+#define USB_CFG_STATS_REQUEST           0x53
+/* bRequest of the vendor IN request that reads usbStats. Must not be used by
+ * usbFunctionSetup().
+ */
 #define USB_CFG_HAVE_MEASURE_FRAME_LENGTH   1
+#define USB_CFG_OSCCAL_TRACKING             1
+/* define this macro to 1 to keep OSCCAL calibrated while the device runs,
+ * see osccal.h. Each measurement disables interrupts for one frame (1 ms).
+ */
 #include "osccal.h"
 /* define this macro to 1 if you want the function usbMeasureFrameLength()
  * compiled in. This function can be used to calibrate the AVR's RC oscillator.
@@ -241,7 +260,32 @@ section at the end of this file).
  * HID class is 3, no subclass and protocol required (but may be useful!)
  * CDC class is 2, use subclass 2 and protocol 1 for ACM
  */
-#define USB_CFG_HID_REPORT_DESCRIPTOR_LENGTH    53
+#define DIGIJOYSTICK_AXES               6
+#define DIGIJOYSTICK_AXIS_BITS          8
+#define DIGIJOYSTICK_HAT                0
+#define DIGIJOYSTICK_BUTTONS            16
+/* The report of DigiJoystick, in this order:
+ * DIGIJOYSTICK_AXES (1 to 8) axes X, Y, Rx, Ry, Rz, Slider, Z, Dial of
+ * DIGIJOYSTICK_AXIS_BITS (8 to 16) each, an optional 8 way hat switch
+ * (DIGIJOYSTICK_HAT 1, 4 bits) and DIGIJOYSTICK_BUTTONS (0 to 32) buttons,
+ * packed without gaps and padded to a byte. A low speed report holds at most
+ * 8 bytes, e.g. 3 axes of 16 bit and 16 buttons, 4 axes of 10 bit, a hat and
+ * 20 buttons or the default 6 axes of 8 bit and 16 buttons.
+ * It must be configured here, since the descriptor length goes into the
+ * configuration descriptor built by usbdrv.c.
+ */
+#define DIGIJOYSTICK_REPORT_BITS        (DIGIJOYSTICK_AXES * DIGIJOYSTICK_AXIS_BITS + DIGIJOYSTICK_HAT * 4 + DIGIJOYSTICK_BUTTONS)
+#define DIGIJOYSTICK_PADDING_BITS       ((8 - DIGIJOYSTICK_REPORT_BITS % 8) % 8)
+#define DIGIJOYSTICK_REPORT_SIZE        ((DIGIJOYSTICK_REPORT_BITS + 7) / 8)
+#if DIGIJOYSTICK_AXES < 1 || DIGIJOYSTICK_AXES > 8 || DIGIJOYSTICK_AXIS_BITS < 8 || DIGIJOYSTICK_AXIS_BITS > 16 \
+        || DIGIJOYSTICK_HAT > 1 || DIGIJOYSTICK_BUTTONS > 32
+#error "DIGIJOYSTICK_AXES, DIGIJOYSTICK_AXIS_BITS, DIGIJOYSTICK_HAT or DIGIJOYSTICK_BUTTONS out of range"
+#endif
+#if DIGIJOYSTICK_REPORT_SIZE > 8
+#error "The DigiJoystick report must not exceed 8 bytes, use fewer axes, bits or buttons"
+#endif
+#define USB_CFG_HID_REPORT_DESCRIPTOR_LENGTH    (22 + 2 * DIGIJOYSTICK_AXES + (DIGIJOYSTICK_AXIS_BITS < 16 ? 3 : 5) \
+        + (DIGIJOYSTICK_HAT ? 23 : 0) + (DIGIJOYSTICK_BUTTONS ? 16 : 0) + (DIGIJOYSTICK_PADDING_BITS ? 6 : 0))
 /* Define this to the length of the HID report descriptor, if you implement
  * an HID device. Otherwise don't define it or define it to 0.
  * If you use this define, you must add a PROGMEM character array named
@@ -14,6 +14,15 @@
 #include <string.h>
 
 #include "usbdrv.h"
+/*
+ * #define USE_UTF8_KEYBOARD_LAYOUT before including DigiKeyboard.h to type UTF-8 strings with the
+ * compiled table of the selected LAYOUT_* (see extras/compile_layouts.py).
+ * Characters above 0x7F and dead key sequences are then typed, not only ASCII.
+ * Including one of the layouts/KeyboardLayout_*.h files directly does the same.
+ */
+#if defined(USE_UTF8_KEYBOARD_LAYOUT) && !defined(KEYBOARD_LAYOUT_COMPILED)
+#include "layouts/KeyboardLayouts.h"
+#endif
 #include "keylayouts.h"
 
 typedef uint8_t byte;
@@ -23,9 +32,29 @@ typedef uint8_t byte;
 #define BUFFER_SIZE 2 // Minimum of 2: 1 for modifiers + 1 for keystroke
 
 static uchar idleRate;           // in 4 ms units
+static uchar setReportType;      // of the SET_REPORT whose data usbFunctionWrite() receives
+static uchar setReportPosition;  // bytes of this report received so far
+static uchar setReportLength;    // bytes announced by the host
+
+/*
+ * Bits of getLedState(), set by the host
+ */
+#define LED_NUM_LOCK    0x01
+#define LED_CAPS_LOCK   0x02
+#define LED_SCROLL_LOCK 0x04
+#define LED_COMPOSE     0x08
+#define LED_KANA        0x10
+
+#if DIGIKEYBOARD_FEATURE_REPORT_SIZE > 0
+#define KEYBOARD_REPORT_ID  1
+#define FEATURE_REPORT_ID   2
+#define REPORT_ID_SIZE      1 // all reports start with their ID
+#else
+#define REPORT_ID_SIZE      0
+#endif
 
 /* We use a simplifed keyboard report descriptor which does not support the
- * boot protocol. We don't allow setting status LEDs and but we do allow
+ * boot protocol. The host can set the status LEDs and we do allow
  * simultaneous key presses.
  * The report descriptor has been created with usb.org's "HID Descriptor Tool"
  * which can be downloaded from http://www.usb.org/developers/hidpage/.
@@ -36,6 +65,9 @@ const PROGMEM uchar usbHidReportDescriptor[USB_CFG_HID_REPORT_DESCRIPTOR_LENGTH]
 0x05, 0x01,                    // USAGE_PAGE (Generic Desktop)
         0x09, 0x06,                    // USAGE (Keyboard)
         0xa1, 0x01,                    // COLLECTION (Application)
+#if DIGIKEYBOARD_FEATURE_REPORT_SIZE > 0
+        0x85, KEYBOARD_REPORT_ID,      //   REPORT_ID (1)
+#endif
         0x05, 0x07,                    //   USAGE_PAGE (Keyboard)
         0x19, 0xe0,                    //   USAGE_MINIMUM (Keyboard LeftControl)
         0x29, 0xe7,                    //   USAGE_MAXIMUM (Keyboard Right GUI)
@@ -44,6 +76,15 @@ const PROGMEM uchar usbHidReportDescriptor[USB_CFG_HID_REPORT_DESCRIPTOR_LENGTH]
         0x75, 0x01,                    //   REPORT_SIZE (1)
         0x95, 0x08,                    //   REPORT_COUNT (8)
         0x81, 0x02,                    //   INPUT (Data,Var,Abs)
+        0x95, 0x05,                    //   REPORT_COUNT (5)
+        0x05, 0x08,                    //   USAGE_PAGE (LEDs)
+        0x19, 0x01,                    //   USAGE_MINIMUM (Num Lock)
+        0x29, 0x05,                    //   USAGE_MAXIMUM (Kana)
+        0x91, 0x02,                    //   OUTPUT (Data,Var,Abs)
+        0x95, 0x01,                    //   REPORT_COUNT (1)
+        0x75, 0x03,                    //   REPORT_SIZE (3)
+        0x91, 0x03,                    //   OUTPUT (Cnst,Var,Abs)
+        0x05, 0x07,                    //   USAGE_PAGE (Keyboard)
         0x95, 0x01,                    //   REPORT_COUNT (simultaneous keystrokes)
         0x75, 0x08,                    //   REPORT_SIZE (8)
         0x25, 0x73,                    //   LOGICAL_MAXIMUM (115)
@@ -51,6 +92,19 @@ const PROGMEM uchar usbHidReportDescriptor[USB_CFG_HID_REPORT_DESCRIPTOR_LENGTH]
         0x29, 0x73,                    //   USAGE_MAXIMUM (Keyboard Application)
         0x81, 0x00,                    //   INPUT (Data,Ary,Abs)
         0xc0                           // END_COLLECTION
+#if DIGIKEYBOARD_FEATURE_REPORT_SIZE > 0
+        , 0x06, 0x00, 0xff,            // USAGE_PAGE (Vendor Defined Page 1)
+        0x09, 0x01,                    // USAGE (Vendor Usage 1)
+        0xa1, 0x01,                    // COLLECTION (Application)
+        0x85, FEATURE_REPORT_ID,       //   REPORT_ID (2)
+        0x15, 0x00,                    //   LOGICAL_MINIMUM (0)
+        0x26, 0xff, 0x00,              //   LOGICAL_MAXIMUM (255)
+        0x75, 0x08,                    //   REPORT_SIZE (8)
+        0x95, DIGIKEYBOARD_FEATURE_REPORT_SIZE, // REPORT_COUNT
+        0x09, 0x01,                    //   USAGE (Vendor Usage 1)
+        0xb1, 0x02,                    //   FEATURE (Data,Var,Abs)
+        0xc0                           // END_COLLECTION
+#endif
         };
 
 #define MOD_CONTROL_LEFT    MODIFIERKEY_LEFT_CTRL
@@ -62,6 +116,8 @@ const PROGMEM uchar usbHidReportDescriptor[USB_CFG_HID_REPORT_DESCRIPTOR_LENGTH]
 #define MOD_ALT_RIGHT       MODIFIERKEY_RIGHT_ALT
 #define MOD_GUI_RIGHT       MODIFIERKEY_RIGHT_GUI
 
+static void digiKeyboardService(void);
+
 class DigiKeyboardDevice: public Print {
 public:
     DigiKeyboardDevice() {
@@ -77,21 +133,40 @@ public:
         // TODO: Remove the next two lines once we fix
         //       missing first keystroke bug properly.
         memset(reportBuffer, 0, sizeof(reportBuffer));
+#if DIGIKEYBOARD_FEATURE_REPORT_SIZE > 0
+        reportBuffer[0] = KEYBOARD_REPORT_ID;
+        featureReport[0] = FEATURE_REPORT_ID;
+#endif
         usbSetInterrupt(reportBuffer, sizeof(reportBuffer));
+        schedulerSetService(digiKeyboardService, SCHEDULER_USB_INTERVAL_US);
     }
 
     void update() {
         usbPoll();
+        if (typePtr && usbInterruptIsReady()) {
+            typeStep();
+        }
+    }
+
+    /*
+     * Type a flash string in the background: one report per interrupt-IN slot is
+     * sent from update() (or delay()), so the sketch keeps running meanwhile.
+     * A key is only released before it is pressed again: "ab" is 2 reports, "aa" 3.
+     * A new call replaces the string being typed. ASCII only, dead keys and UTF-8 need print().
+     */
+    void typeAsync(const __FlashStringHelper *aString) {
+        typePtr = reinterpret_cast<const char*>(aString);
+    }
+
+    // true until the last key of the typeAsync() string is released
+    bool typing() {
+        return typePtr != NULL;
     }
 
-    // delay while updating until we are finished delaying
+    // delay while updating until we are finished delaying, runs the schedulerAdd() tasks too
     void delay(long milli) {
-        unsigned long last = millis();
-        while (milli > 0) {
-            unsigned long now = millis();
-            milli -= now - last;
-            last = now;
-            update();
+        if (milli > 0) {
+            schedulerDelay(milli);
         }
     }
 
@@ -144,10 +219,8 @@ public:
             _delay_ms(5);
         }
 
-        memset(reportBuffer, 0, sizeof(reportBuffer));
-
-        reportBuffer[0] = modifiers;
-        reportBuffer[1] = keyPress;
+        reportBuffer[REPORT_ID_SIZE] = modifiers;
+        reportBuffer[REPORT_ID_SIZE + 1] = keyPress;
 
         usbSetInterrupt(reportBuffer, sizeof(reportBuffer));
     }
@@ -182,9 +255,9 @@ public:
     }
 
     /*
-     * Convert ASCII to USB code
+     * Convert ASCII to the keycode of keylayouts.h, 0 if there is none
      */
-    size_t write(uint8_t chr) {
+    uint8_t char_to_keycode(uint8_t chr) {
         uint8_t data = 0;
         if (chr == '\b') {
             data = (uint8_t) KEY_BACKSPACE; // 0x08
@@ -194,23 +267,180 @@ public:
             data = (uint8_t) KEY_ENTER;     // 0x0A
         } else if (chr == '\r') {
             data = (uint8_t) KEY_ENTER;     // 0x0D
-        } else if (chr >= 0x20) {
+        } else if (chr >= 0x20 && chr < 0x80) {
             // read from mapping table
             data = pgm_read_byte_near(keycodes_ascii + (chr - 0x20));
         }
-        if (data) {
-            sendKeyStroke(keycode_to_key(data), keycode_to_modifier(data), sUseFeedbackLed);
+        return data;
+    }
+
+#if defined(KEYBOARD_LAYOUT_COMPILED)
+    /*
+     * Binary search in the compiled layout, 0 if the character has no key.
+     * Returns the keycode and the index of its dead key in bits 8 to 11.
+     */
+    uint16_t unicode_to_keycode(uint16_t aCodePoint) {
+        uint8_t tLow = 0;
+        uint8_t tHigh = sizeof(keycodes_unicode) / sizeof(keycodes_unicode[0]) - 1; // the 0xFFFF end mark
+        while (tLow < tHigh) {
+            uint8_t tMiddle = (tLow + tHigh) / 2;
+            if (pgm_read_word(&keycodes_unicode[tMiddle]) < aCodePoint) {
+                tLow = tMiddle + 1;
+            } else {
+                tHigh = tMiddle;
+            }
+        }
+        if (pgm_read_word(&keycodes_unicode[tLow]) == aCodePoint) {
+            return pgm_read_word(&keycodes_unicode_data[tLow]);
+        }
+        return 0;
+    }
+
+    bool is_deadkey(uint8_t keycode) {
+        for (uint8_t i = 0; i < sizeof(keycodes_deadkey); ++i) {
+            if (pgm_read_byte(&keycodes_deadkey[i]) == keycode) {
+                return true;
+            }
+        }
+        return false;
+    }
+#endif
+
+    /*
+     * Type a keycode of the layout tables, with its dead key first if it has one.
+     * A dead key character on its own is followed by a space, otherwise the host waits for the next key.
+     */
+    void type_keycode(uint16_t data) {
+        if (!data) {
+            return;
         }
+#if defined(KEYBOARD_LAYOUT_COMPILED)
+        uint8_t tDeadKeyIndex = data >> 8;
+        if (tDeadKeyIndex) {
+            uint8_t tDeadKey = pgm_read_byte(&keycodes_deadkey[tDeadKeyIndex - 1]);
+            sendKeyStroke(keycode_to_key(tDeadKey), keycode_to_modifier(tDeadKey), sUseFeedbackLed);
+        }
+#endif
+        sendKeyStroke(keycode_to_key(data), keycode_to_modifier(data), sUseFeedbackLed);
+#if defined(KEYBOARD_LAYOUT_COMPILED)
+        if (!tDeadKeyIndex && is_deadkey(data)) {
+            sendKeyStroke((uint8_t) KEY_SPACE, 0, sUseFeedbackLed);
+        }
+#endif
+    }
+
+    /*
+     * Convert ASCII to USB code.
+     * With a compiled layout, the bytes of a UTF-8 sequence are collected and the character is typed after its last byte.
+     */
+    size_t write(uint8_t chr) {
+#if defined(KEYBOARD_LAYOUT_COMPILED)
+        if (chr >= 0x80) {
+            if (chr >= 0xC0) {
+                // start byte: number of following bytes and the payload bits
+                utf8Remaining = (chr >= 0xE0) ? ((chr >= 0xF0) ? 3 : 2) : 1;
+                utf8CodePoint = (utf8Remaining == 3) ? 0xFFFF : chr & (0x3F >> utf8Remaining); // no keys above 0xFFFF
+            } else if (utf8Remaining) {
+                if (utf8CodePoint != 0xFFFF) {
+                    utf8CodePoint = (utf8CodePoint << 6) | (chr & 0x3F);
+                }
+                if (--utf8Remaining == 0) {
+                    type_keycode(unicode_to_keycode(utf8CodePoint));
+                }
+            }
+            return 1;
+        }
+        utf8Remaining = 0;
+#endif
+        type_keycode(char_to_keycode(chr));
         return 1;
     }
 
+    /*
+     * The callback is called from update() with the new LED_* bits, when the host changes them.
+     * Keep it short, USB is not polled while it runs.
+     */
+    void onLedChange(void (*aLedChangeCallback)(uint8_t aLedState)) {
+        ledChangeCallback = aLedChangeCallback;
+    }
+
+    uint8_t getLedState() {
+        return ledState;
+    }
+
+#if DIGIKEYBOARD_FEATURE_REPORT_SIZE > 0
+    /*
+     * The callback is called from update() with the DIGIKEYBOARD_FEATURE_REPORT_SIZE bytes
+     * of each feature report sent by the host. The host reads back the last one.
+     */
+    void onFeatureReport(void (*aFeatureReportCallback)(uint8_t *aData)) {
+        featureReportCallback = aFeatureReportCallback;
+    }
+#endif
+
     bool sUseFeedbackLed = false;
-    uchar reportBuffer[2];    // buffer for HID reports [ 1 modifier byte + (len-1) key strokes]
+    uchar reportBuffer[REPORT_ID_SIZE + 2]; // buffer for HID reports [ (report ID) + 1 modifier byte + (len-1) key strokes]
+    uint8_t ledState = 0;
+    void (*ledChangeCallback)(uint8_t aLedState) = NULL;
+#if DIGIKEYBOARD_FEATURE_REPORT_SIZE > 0
+    uchar featureReport[REPORT_ID_SIZE + DIGIKEYBOARD_FEATURE_REPORT_SIZE];
+    void (*featureReportCallback)(uint8_t *aData) = NULL;
+#endif
     using Print::write;
+
+private:
+    const char *typePtr = NULL; // next character of the typeAsync() string, in flash
+    uint8_t typeKey = 0;        // key pressed by the last report sent by typeStep()
+#if defined(KEYBOARD_LAYOUT_COMPILED)
+    uint16_t utf8CodePoint;     // bits of the UTF-8 sequence received by write() so far
+    uint8_t utf8Remaining = 0;  // bytes still missing in this sequence
+#endif
+
+    // called when the previous report has been taken by the host
+    void typeStep() {
+        uint8_t chr = pgm_read_byte(typePtr);
+        uint8_t data, key;
+
+        if (chr == 0) {
+            // end of string: release the last key, then done
+            if (typeKey) {
+                typeKey = 0;
+                typeReport(0, 0);
+            } else {
+                typePtr = NULL;
+            }
+            return;
+        }
+        data = char_to_keycode(chr);
+        if (!data) {
+            typePtr++; // nothing to type for this one
+            return;
+        }
+        key = keycode_to_key(data);
+        if (key == typeKey) {
+            // same key again: the host only sees a new press after a release
+            typeKey = 0;
+            typeReport(0, 0);
+            return;
+        }
+        typeKey = key;
+        typePtr++;
+        typeReport(key, keycode_to_modifier(data));
+    }
+
+    void typeReport(uint8_t keyPress, uint8_t modifiers) {
+        reportBuffer[REPORT_ID_SIZE] = modifiers;
+        reportBuffer[REPORT_ID_SIZE + 1] = keyPress;
+        usbSetInterrupt(reportBuffer, sizeof(reportBuffer));
+    }
 };
 
 DigiKeyboardDevice DigiKeyboard = DigiKeyboardDevice();
 
+static void digiKeyboardService(void) {
+    DigiKeyboard.update();
+}
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -225,7 +455,13 @@ uchar usbFunctionSetup(uchar data[8]) {
         if (rq->bRequest == USBRQ_HID_GET_REPORT) {
             /* wValue: ReportType (highbyte), ReportID (lowbyte) */
 
-            /* we only have one report type, so don't look at wValue */
+#if DIGIKEYBOARD_FEATURE_REPORT_SIZE > 0
+            if (rq->wValue.bytes[1] == 3) { // feature report
+                usbMsgPtr = DigiKeyboard.featureReport;
+                return sizeof(DigiKeyboard.featureReport);
+            }
+#endif
+            /* we only have one input report, so don't look at wValue */
             // TODO: Ensure it's okay not to return anything here?
             return 0;
 
@@ -237,6 +473,12 @@ uchar usbFunctionSetup(uchar data[8]) {
         } else if (rq->bRequest == USBRQ_HID_SET_IDLE) {
             idleRate = rq->wValue.bytes[1];
 
+        } else if (rq->bRequest == USBRQ_HID_SET_REPORT) {
+            /* wValue: ReportType (highbyte), ReportID (lowbyte), the data comes with usbFunctionWrite() */
+            setReportType = rq->wValue.bytes[1];
+            setReportPosition = 0;
+            setReportLength = rq->wLength.bytes[1] ? 0xff : rq->wLength.bytes[0];
+            return USB_NO_MSG;
         }
     } else {
         /* no vendor specific requests implemented */
@@ -244,6 +486,48 @@ uchar usbFunctionSetup(uchar data[8]) {
 
     return 0;
 }
+
+/*
+ * Data of SET_REPORT, at most 8 bytes per call.
+ * Returns 1 when the report is complete.
+ */
+uchar usbFunctionWrite(uchar *data, uchar len) {
+    if (setReportType == 2) {
+        // output report: the LED byte, after the report ID if there is one
+        if (setReportPosition + len > REPORT_ID_SIZE) {
+            uint8_t tLedState = data[REPORT_ID_SIZE - setReportPosition];
+            if (tLedState != DigiKeyboard.ledState) {
+                DigiKeyboard.ledState = tLedState;
+                if (DigiKeyboard.ledChangeCallback != NULL) {
+                    DigiKeyboard.ledChangeCallback(tLedState);
+                }
+            }
+            return 1;
+        }
+        setReportPosition += len;
+        return setReportPosition >= setReportLength;
+    }
+#if DIGIKEYBOARD_FEATURE_REPORT_SIZE > 0
+    if (setReportType == 3) {
+        // feature report: keep the report ID of our buffer
+        while (len--) {
+            if (setReportPosition >= REPORT_ID_SIZE && setReportPosition < sizeof(DigiKeyboard.featureReport)) {
+                DigiKeyboard.featureReport[setReportPosition] = *data;
+            }
+            data++;
+            setReportPosition++;
+        }
+        if (setReportPosition < setReportLength) {
+            return 0;
+        }
+        if (DigiKeyboard.featureReportCallback != NULL) {
+            DigiKeyboard.featureReportCallback(&DigiKeyboard.featureReport[REPORT_ID_SIZE]);
+        }
+        return 1;
+    }
+#endif
+    return 0xff; // stall
+}
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -0,0 +1,30 @@
+/*
+ * Type a text while the loop keeps blinking the LED.
+ * The text is sent by DigiKeyboard.update(), one key per USB interrupt slot,
+ * which is much faster than print() with its key press and release reports.
+ */
+#include "DigiKeyboard.h"
+
+#define LED_PIN 1 // built in LED of Digispark and Digispark Pro
+
+unsigned long sLastTypeMillis;
+unsigned long sLastBlinkMillis;
+
+void setup() {
+    pinMode(LED_PIN, OUTPUT);
+}
+
+void loop() {
+    // must be called often, at least every 50 ms
+    DigiKeyboard.update();
+
+    if (!DigiKeyboard.typing() && millis() - sLastTypeMillis > 5000) {
+        sLastTypeMillis = millis();
+        DigiKeyboard.typeAsync(F("Hello Digispark! Typed in the background, look: aa bb 11\n"));
+    }
+
+    if (millis() - sLastBlinkMillis > 100) {
+        sLastBlinkMillis = millis();
+        digitalWrite(LED_PIN, !digitalRead(LED_PIN));
+    }
+}
@@ -0,0 +1,43 @@
+/*
+ * Show the Caps Lock state of the host on the built in LED.
+ * All keyboards of the host share the lock states, so pressing Caps Lock on
+ * the real keyboard switches the LED too.
+ *
+ * If DIGIKEYBOARD_FEATURE_REPORT_SIZE is set in usbconfig.h of the library,
+ * the host can also send data to the sketch without any driver, e.g. with the
+ * HIDIOCSFEATURE ioctl on a Linux /dev/hidraw device or HidD_SetFeature() on Windows.
+ */
+#include "DigiKeyboard.h"
+
+void ledChanged(uint8_t aLedState) {
+    digitalWrite(LED_BUILTIN, (aLedState & LED_CAPS_LOCK) ? HIGH : LOW);
+}
+
+#if DIGIKEYBOARD_FEATURE_REPORT_SIZE > 0
+char sReceived[DIGIKEYBOARD_FEATURE_REPORT_SIZE + 1];
+volatile bool sReceivedValid = false;
+
+// called within usbPoll(), so do not type from here
+void featureReceived(uint8_t *aData) {
+    memcpy(sReceived, aData, DIGIKEYBOARD_FEATURE_REPORT_SIZE);
+    sReceivedValid = true;
+}
+#endif
+
+void setup() {
+    pinMode(LED_BUILTIN, OUTPUT);
+    DigiKeyboard.onLedChange(&ledChanged);
+#if DIGIKEYBOARD_FEATURE_REPORT_SIZE > 0
+    DigiKeyboard.onFeatureReport(&featureReceived);
+#endif
+}
+
+void loop() {
+    DigiKeyboard.update();
+#if DIGIKEYBOARD_FEATURE_REPORT_SIZE > 0
+    if (sReceivedValid) {
+        sReceivedValid = false;
+        DigiKeyboard.println(sReceived); // type back what was received
+    }
+#endif
+}
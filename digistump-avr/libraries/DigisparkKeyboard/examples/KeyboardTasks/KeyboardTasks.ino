@@ -0,0 +1,37 @@
+// Tasks run by the core scheduler while DigiKeyboard keeps USB serviced.
+// Each task declares how long it may take; it only runs when that still fits
+// before usbPoll() is due again, so no delay has to be tuned by hand.
+
+#include "DigiKeyboard.h"
+
+#define BUTTON_PIN 0
+
+bool buttonPressed = false;
+
+void blinkTask() {
+  digitalWrite(LED_BUILTIN, !digitalRead(LED_BUILTIN));
+}
+
+void buttonTask() {
+  static byte history = 0xFF;
+  history = (history << 1) | digitalRead(BUTTON_PIN);
+  if (history == 0x80) { // released for 7 scans, then pressed: debounced
+    buttonPressed = true;
+  }
+}
+
+void setup() {
+  pinMode(LED_BUILTIN, OUTPUT);
+  pinMode(BUTTON_PIN, INPUT_PULLUP);
+  schedulerAdd(blinkTask, 500, 50);  // every 500 ms, takes well under 50 us
+  schedulerAdd(buttonTask, 5, 50);   // every 5 ms
+}
+
+void loop() {
+  if (buttonPressed) {
+    buttonPressed = false;
+    DigiKeyboard.typeAsync(F("Button pressed\n"));
+  }
+  // usbPoll(), typeAsync() and the tasks all run in here
+  DigiKeyboard.delay(10);
+}
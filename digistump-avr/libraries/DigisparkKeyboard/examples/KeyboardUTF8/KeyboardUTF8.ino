@@ -0,0 +1,20 @@
+/*
+ * Type UTF-8 text, with the umlauts and accents of the host keyboard layout.
+ * Select the layout of the host, the compiled table of only this layout is put into flash.
+ * The tables in layouts/ are generated from keylayouts.h by extras/compile_layouts.py.
+ */
+#define LAYOUT_GERMAN
+//#define LAYOUT_FRENCH
+//#define LAYOUT_SPANISH
+//#define LAYOUT_US_INTERNATIONAL
+#define USE_UTF8_KEYBOARD_LAYOUT
+#include "DigiKeyboard.h"
+
+void setup() {
+}
+
+void loop() {
+    DigiKeyboard.delay(5000);
+    // characters without a key in the selected layout are skipped
+    DigiKeyboard.println(F("Grüße aus Köln, déjà vu, ^ und ` - 20 €"));
+}
@@ -0,0 +1,221 @@
+#!/usr/bin/env python3
+"""
+Compile the layouts of keylayouts.h into the compact tables of layouts/KeyboardLayout_<NAME>.h
+
+    python3 extras/compile_layouts.py [LAYOUT_GERMAN ...]
+
+Without arguments all layouts are compiled. Needs the C preprocessor (cpp) of a host gcc,
+which resolves the nested #ifdefs of keylayouts.h; the values are then evaluated here.
+
+Output of each layout:
+    keycodes_ascii[96]    0x20 to 0x7F, 6 bit scancode | SHIFT_MASK | ALTGR_MASK, 0 = no key
+    keycodes_deadkey[13]  the dead key of each *_BITS index 1 to 13, 0 = layout has none
+    keycodes_unicode[]    sorted code points above 0x7F, terminated by 0xFFFF
+    keycodes_unicode_data[] the keycode of each code point, dead key index in bits 8 to 11
+"""
+
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+LIBRARY = os.path.dirname(HERE)
+KEYLAYOUTS = os.path.join(LIBRARY, 'keylayouts.h')
+OUTPUT = os.path.join(LIBRARY, 'layouts')
+
+# Evaluated instead of the real masks, so that they cannot be confused with scancode bits
+SHIFT = 0x10000
+ALTGR = 0x20000
+NON_US_BS = 0x64
+NON_US_BS_MAPPING = 0x3F  # must match KEY_NON_US_BS_MAPPING
+
+
+class Unsupported(Exception):
+    pass
+
+
+def preprocess(layout, tmp):
+    """All macros defined by keylayouts.h for this layout, None if the layout is not supported"""
+    result = subprocess.run(['cpp', '-dM', '-undef', '-nostdinc', '-I', tmp, '-D' + layout, KEYLAYOUTS],
+                            stdout=subprocess.PIPE, stderr=subprocess.PIPE, universal_newlines=True)
+    if result.returncode:
+        errors = [line for line in result.stderr.splitlines() if 'error' in line] or ['cpp failed']
+        sys.stderr.write('%s skipped: %s\n' % (layout, errors[0]))
+        return None
+    macros = {}
+    for line in result.stdout.splitlines():
+        m = re.match(r'#define (\w+) (.*)$', line)
+        if m:
+            macros[m.group(1)] = m.group(2).strip()
+    return macros
+
+
+def evaluate(macros, name):
+    """Value of a macro, with SHIFT_MASK and ALTGR_MASK moved above the 16 bit keycodes"""
+    expr = macros[name]
+
+    def substitute(m):
+        word = m.group(0)
+        if word == 'SHIFT_MASK':
+            return str(SHIFT)
+        if word == 'ALTGR_MASK':
+            return str(ALTGR)
+        if word == 'KEY_NON_US_BS_MAPPING':
+            return str(0xF000 | NON_US_BS)
+        if re.match(r'0[xX][0-9a-fA-F]+$|\d+$', word):
+            return word
+        if word not in macros:
+            raise Unsupported(word)
+        return '(%d)' % evaluate(macros, word)
+
+    return eval(re.sub(r'\b\w+\b', substitute, expr))
+
+
+def compact(value):
+    """16 bit value of keylayouts.h to the 8 bit keycode, dead key index in bits 8 to 11"""
+    if value == 0:
+        return 0
+    scancode = value & 0xFF
+    if scancode == NON_US_BS:
+        scancode = NON_US_BS_MAPPING
+    elif scancode >= NON_US_BS_MAPPING:
+        raise Unsupported('scancode 0x%02X' % scancode)
+    keycode = scancode | (0x40 if value & SHIFT else 0) | (0x80 if value & ALTGR else 0)
+    return keycode | (value & 0x0F00)
+
+
+def compile_layout(layout, macros):
+    def keycode(name, text):
+        try:
+            return compact(evaluate(macros, name))
+        except Unsupported as e:
+            sys.stderr.write('%s: %s not supported (%s)\n' % (layout, text, e))
+            return 0
+
+    ascii_codes = []
+    for c in range(0x20, 0x80):
+        ascii_codes.append(keycode('ASCII_%02X' % c, 'ASCII 0x%02X' % c) & 0xFF)
+
+    deadkeys = [0] * 13
+    for name in macros:
+        m = re.match(r'(\w+)_BITS$', name)
+        if m and 'DEADKEY_' + m.group(1) in macros:
+            index = evaluate(macros, name) >> 8
+            if 1 <= index <= 13:
+                deadkeys[index - 1] = keycode('DEADKEY_' + m.group(1), 'dead key ' + m.group(1)) & 0xFF
+
+    unicode = {}
+    for name in macros:
+        m = re.match(r'ISO_8859_1_([0-9A-F]{2})$', name)
+        if m:
+            unicode[int(m.group(1), 16)] = keycode(name, 'U+00' + m.group(1))
+        m = re.match(r'UNICODE_([0-9A-F]{4})$', name)
+        if m:
+            unicode[int(m.group(1), 16)] = keycode(name, 'U+' + m.group(1))
+        m = re.match(r'UNICODE_EXTRA(\w+)$', name)
+        if m and 'KEYCODE_EXTRA' + m.group(1) in macros:
+            unicode[evaluate(macros, name)] = keycode('KEYCODE_EXTRA' + m.group(1), macros[name])
+    for cp in list(unicode):
+        dead = unicode[cp] >> 8
+        if dead and not deadkeys[dead - 1]:
+            sys.stderr.write('%s: U+%04X needs a dead key the layout does not have\n' % (layout, cp))
+            unicode[cp] = 0
+        if not unicode[cp] or cp < 0x80:
+            del unicode[cp]
+    return ascii_codes, deadkeys, sorted(unicode.items())
+
+
+def rows(values, fmt, per_row):
+    lines = []
+    for i in range(0, len(values), per_row):
+        lines.append('    ' + ', '.join(fmt % v for v in values[i:i + per_row]))
+    return ',\n'.join(lines)
+
+
+def write_layout(layout, tables):
+    ascii_codes, deadkeys, unicode = tables
+    name = layout[len('LAYOUT_'):]
+    with open(os.path.join(OUTPUT, 'KeyboardLayout_%s.h' % name), 'w') as f:
+        f.write('''/*
+ * KeyboardLayout_%(name)s.h
+ * Generated by extras/compile_layouts.py from %(layout)s of keylayouts.h - do not edit.
+ * %(ascii)d bytes ASCII, %(dead)d bytes dead keys, %(uni)d bytes for %(count)d other characters.
+ */
+#ifndef KEYBOARD_LAYOUT_COMPILED
+#define KEYBOARD_LAYOUT_COMPILED %(layout)s
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+
+const uint8_t keycodes_ascii[] PROGMEM = {
+%(ascii_rows)s
+};
+
+const uint8_t keycodes_deadkey[] PROGMEM = {
+%(dead_rows)s
+};
+
+const uint16_t keycodes_unicode[] PROGMEM = {
+%(uni_rows)s
+};
+
+const uint16_t keycodes_unicode_data[] PROGMEM = {
+%(data_rows)s
+};
+
+#endif // KEYBOARD_LAYOUT_COMPILED
+''' % {
+            'name': name, 'layout': layout,
+            'ascii': len(ascii_codes), 'dead': len(deadkeys), 'uni': 4 * (len(unicode) + 1), 'count': len(unicode),
+            'ascii_rows': rows(ascii_codes, '0x%02X', 16),
+            'dead_rows': rows(deadkeys, '0x%02X', 13),
+            'uni_rows': rows([cp for cp, _ in unicode] + [0xFFFF], '0x%04X', 8),
+            'data_rows': rows([data for _, data in unicode] + [0], '0x%03X', 8),
+        })
+
+
+def write_index(layouts):
+    with open(os.path.join(OUTPUT, 'KeyboardLayouts.h'), 'w') as f:
+        f.write('''/*
+ * KeyboardLayouts.h
+ * Generated by extras/compile_layouts.py - do not edit.
+ * Includes the compiled table of the LAYOUT_* defined before including DigiKeyboard.h.
+ */
+''')
+        layouts = [layout for layout in layouts if layout != 'LAYOUT_US_ENGLISH']
+        for i, layout in enumerate(layouts):
+            f.write('#%s defined(%s)\n#include "KeyboardLayout_%s.h"\n'
+                    % ('if' if i == 0 else 'elif', layout, layout[len('LAYOUT_'):]))
+        f.write('#else\n#include "KeyboardLayout_US_ENGLISH.h"\n#endif\n')
+
+
+def main():
+    with open(KEYLAYOUTS, encoding='latin-1') as f:
+        found = re.findall(r'defined\((LAYOUT_\w+)\)|#ifdef (LAYOUT_\w+)', f.read())
+    layouts = []
+    for a, b in found:
+        name = a or b
+        if name not in layouts and name != 'LAYOUT_UNSPECIFIED':
+            layouts.append(name)
+    selected = sys.argv[1:] or layouts
+
+    if not os.path.isdir(OUTPUT):
+        os.mkdir(OUTPUT)
+    compiled = []
+    with tempfile.TemporaryDirectory() as tmp:
+        os.mkdir(os.path.join(tmp, 'avr'))
+        for stub in ('stdint.h', os.path.join('avr', 'pgmspace.h')):
+            open(os.path.join(tmp, stub), 'w').close()
+        for layout in selected:
+            macros = preprocess(layout, tmp)
+            if macros is not None:
+                write_layout(layout, compile_layout(layout, macros))
+                compiled.append(layout)
+    if not sys.argv[1:]:
+        write_index(compiled)
+
+
+if __name__ == '__main__':
+    main()
@@ -288,6 +288,8 @@ extern "C" {
 // Everything below this line is not intended for use in "normal" programs.
 // These private symbols populate lookup tables, which are used to translate
 // ascii and UTF8 unicode into keystroke sequences.
+// A table of layouts/ included before (see KeyboardLayouts.h) replaces all of them.
+#ifndef KEYBOARD_LAYOUT_COMPILED
 
 #ifdef LAYOUT_US_INTERNATIONAL
 
@@ -5395,6 +5397,7 @@ const uint16_t keycodes_iso_8859_1[]PROGMEM={
         M(ISO_8859_1_FC), M(ISO_8859_1_FD), M(ISO_8859_1_FE), M(ISO_8859_1_FF)
     };
 #endif // ISO_8859_1_A0
+#endif // KEYBOARD_LAYOUT_COMPILED
 
 #ifdef __cplusplus
 } // extern "C"
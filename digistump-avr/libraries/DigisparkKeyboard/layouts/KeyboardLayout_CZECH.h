@@ -0,0 +1,41 @@
+/*
+ * KeyboardLayout_CZECH.h
+ * Generated by extras/compile_layouts.py from LAYOUT_CZECH of keylayouts.h - do not edit.
+ * 96 bytes ASCII, 13 bytes dead keys, 140 bytes for 34 other characters.
+ */
+#ifndef KEYBOARD_LAYOUT_COMPILED
+#define KEYBOARD_LAYOUT_COMPILED LAYOUT_CZECH
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+
+const uint8_t keycodes_ascii[] PROGMEM = {
+    0x2C, 0x74, 0x73, 0x9B, 0xB3, 0x6D, 0x86, 0x71, 0x70, 0x30, 0xB8, 0x1E, 0x36, 0x38, 0x37, 0x6F,
+    0x67, 0x5E, 0x5F, 0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x77, 0x35, 0xB6, 0x2D, 0xB7, 0x76,
+    0x99, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4A, 0x4B, 0x4C, 0x4D, 0x4E, 0x4F, 0x50, 0x51, 0x52,
+    0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x5B, 0x5D, 0x5C, 0x89, 0x3F, 0x8A, 0xA0, 0x78,
+    0xA4, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12,
+    0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1D, 0x1C, 0x85, 0x7F, 0x91, 0x9E, 0x2A
+};
+
+const uint8_t keycodes_deadkey[] PROGMEM = {
+    0x2E, 0x75, 0x6E, 0x00, 0xA1, 0xA3, 0x00, 0xA5, 0xA7, 0xAD, 0xAE, 0x00, 0x00
+};
+
+const uint16_t keycodes_unicode[] PROGMEM = {
+    0x00A0, 0x00A4, 0x00A7, 0x00B0, 0x00B4, 0x00B8, 0x00C1, 0x00C7,
+    0x00C9, 0x00CD, 0x00D3, 0x00D7, 0x00DA, 0x00DD, 0x00DF, 0x00E1,
+    0x00E7, 0x00E9, 0x00ED, 0x00F3, 0x00F7, 0x00FA, 0x00FD, 0x010D,
+    0x0110, 0x0111, 0x011B, 0x0141, 0x0142, 0x0159, 0x0161, 0x016F,
+    0x017E, 0x20AC, 0xFFFF
+};
+
+const uint16_t keycodes_unicode_data[] PROGMEM = {
+    0x02C, 0x0B1, 0x034, 0x22C, 0x12C, 0xB2C, 0x144, 0xB46,
+    0x148, 0x14C, 0x152, 0x0B0, 0x158, 0x15D, 0x0B4, 0x025,
+    0xB06, 0x027, 0x026, 0x112, 0x0AF, 0x02F, 0x024, 0x021,
+    0x087, 0x096, 0x01F, 0x08F, 0x08E, 0x022, 0x020, 0x033,
+    0x023, 0x088, 0x000
+};
+
+#endif // KEYBOARD_LAYOUT_COMPILED
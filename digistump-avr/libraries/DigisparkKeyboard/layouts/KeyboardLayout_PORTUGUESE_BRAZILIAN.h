@@ -0,0 +1,49 @@
+/*
+ * KeyboardLayout_PORTUGUESE_BRAZILIAN.h
+ * Generated by extras/compile_layouts.py from LAYOUT_PORTUGUESE_BRAZILIAN of keylayouts.h - do not edit.
+ * 96 bytes ASCII, 13 bytes dead keys, 260 bytes for 64 other characters.
+ */
+#ifndef KEYBOARD_LAYOUT_COMPILED
+#define KEYBOARD_LAYOUT_COMPILED LAYOUT_PORTUGUESE_BRAZILIAN
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+
+const uint8_t keycodes_ascii[] PROGMEM = {
+    0x2C, 0x5E, 0x75, 0x60, 0x61, 0x62, 0x64, 0x35, 0x66, 0x67, 0x65, 0x6E, 0x36, 0x2D, 0x37, 0x94,
+    0x27, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x78, 0x38, 0x76, 0x2E, 0x77, 0x9A,
+    0x5F, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4A, 0x4B, 0x4C, 0x4D, 0x4E, 0x4F, 0x50, 0x51, 0x52,
+    0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x5B, 0x5C, 0x5D, 0x30, 0x3F, 0x31, 0x74, 0x6D,
+    0x6F, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12,
+    0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x70, 0x7F, 0x71, 0x34, 0x2A
+};
+
+const uint8_t keycodes_deadkey[] PROGMEM = {
+    0x2F, 0x00, 0x00, 0x74, 0x00, 0x00, 0x6F, 0x00, 0x00, 0x63, 0x00, 0x34, 0x00
+};
+
+const uint16_t keycodes_unicode[] PROGMEM = {
+    0x00A0, 0x00A2, 0x00A3, 0x00A7, 0x00A8, 0x00AA, 0x00AC, 0x00B0,
+    0x00B2, 0x00B3, 0x00B4, 0x00B9, 0x00BA, 0x00C0, 0x00C1, 0x00C2,
+    0x00C3, 0x00C4, 0x00C7, 0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC,
+    0x00CD, 0x00CE, 0x00CF, 0x00D1, 0x00D2, 0x00D3, 0x00D4, 0x00D5,
+    0x00D6, 0x00D9, 0x00DA, 0x00DB, 0x00DC, 0x00DD, 0x00E0, 0x00E1,
+    0x00E2, 0x00E3, 0x00E4, 0x00E7, 0x00E8, 0x00E9, 0x00EA, 0x00EB,
+    0x00EC, 0x00ED, 0x00EE, 0x00EF, 0x00F1, 0x00F2, 0x00F3, 0x00F4,
+    0x00F5, 0x00F6, 0x00F9, 0x00FA, 0x00FB, 0x00FC, 0x00FD, 0x00FF,
+    0xFFFF
+};
+
+const uint16_t keycodes_unicode_data[] PROGMEM = {
+    0x02C, 0x0A2, 0x0A1, 0x0AE, 0xA2C, 0x0B0, 0x0A3, 0x088,
+    0x09F, 0x09F, 0x12C, 0x09E, 0x0B1, 0x744, 0x144, 0x444,
+    0xC44, 0xA44, 0x073, 0x748, 0x148, 0x448, 0xA48, 0x74C,
+    0x14C, 0x44C, 0xA4C, 0xC51, 0x752, 0x152, 0x452, 0xC52,
+    0xA52, 0x758, 0x158, 0x458, 0xA58, 0x15C, 0x704, 0x104,
+    0x404, 0xC04, 0xA04, 0x033, 0x708, 0x108, 0x408, 0xA08,
+    0x70C, 0x10C, 0x40C, 0xA0C, 0xC11, 0x712, 0x112, 0x412,
+    0xC12, 0xA12, 0x718, 0x118, 0x418, 0xA18, 0x11C, 0xA1C,
+    0x000
+};
+
+#endif // KEYBOARD_LAYOUT_COMPILED
@@ -0,0 +1,55 @@
+/*
+ * KeyboardLayout_SERBIAN_LATIN_ONLY.h
+ * Generated by extras/compile_layouts.py from LAYOUT_SERBIAN_LATIN_ONLY of keylayouts.h - do not edit.
+ * 96 bytes ASCII, 13 bytes dead keys, 380 bytes for 94 other characters.
+ */
+#ifndef KEYBOARD_LAYOUT_COMPILED
+#define KEYBOARD_LAYOUT_COMPILED LAYOUT_SERBIAN_LATIN_ONLY
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+
+const uint8_t keycodes_ascii[] PROGMEM = {
+    0x2C, 0x5E, 0x5F, 0x60, 0x61, 0x62, 0x63, 0x2D, 0x65, 0x66, 0x6E, 0x2E, 0x36, 0x38, 0x37, 0x64,
+    0x27, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x77, 0x76, 0x3F, 0x67, 0x7F, 0x6D,
+    0x99, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4A, 0x4B, 0x4C, 0x4D, 0x4E, 0x4F, 0x50, 0x51, 0x52,
+    0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x5B, 0x5D, 0x5C, 0x89, 0x94, 0x8A, 0x2C, 0x78,
+    0xA4, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12,
+    0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1D, 0x1C, 0x85, 0x9A, 0x91, 0x9E, 0x2A
+};
+
+const uint8_t keycodes_deadkey[] PROGMEM = {
+    0xA6, 0xA2, 0x9F, 0xA0, 0xA1, 0xA3, 0x00, 0xA5, 0xA7, 0xAD, 0x35, 0x00, 0x00
+};
+
+const uint16_t keycodes_unicode[] PROGMEM = {
+    0x00A0, 0x00A4, 0x00A7, 0x00A8, 0x00B0, 0x00B4, 0x00B8, 0x00C1,
+    0x00C2, 0x00C4, 0x00C7, 0x00C9, 0x00CA, 0x00CB, 0x00CD, 0x00CE,
+    0x00CF, 0x00D3, 0x00D4, 0x00D6, 0x00D7, 0x00DA, 0x00DB, 0x00DC,
+    0x00DD, 0x00DF, 0x00E1, 0x00E2, 0x00E4, 0x00E7, 0x00E9, 0x00EA,
+    0x00EB, 0x00ED, 0x00EE, 0x00EF, 0x00F3, 0x00F4, 0x00F6, 0x00F7,
+    0x00FA, 0x00FB, 0x00FC, 0x00FD, 0x0102, 0x0103, 0x0104, 0x0105,
+    0x0106, 0x0107, 0x010C, 0x010D, 0x010E, 0x010F, 0x0110, 0x0111,
+    0x0118, 0x0119, 0x011A, 0x011B, 0x0139, 0x013A, 0x013D, 0x013E,
+    0x0141, 0x0142, 0x0143, 0x0144, 0x0147, 0x0148, 0x0150, 0x0151,
+    0x0154, 0x0155, 0x0158, 0x0159, 0x015A, 0x015B, 0x015E, 0x015F,
+    0x0160, 0x0161, 0x0164, 0x0165, 0x016E, 0x016F, 0x0179, 0x017A,
+    0x017B, 0x017C, 0x017D, 0x017E, 0x201A, 0x20AC, 0xFFFF
+};
+
+const uint16_t keycodes_unicode_data[] PROGMEM = {
+    0x02C, 0x0B1, 0x090, 0xA2C, 0x22C, 0x12C, 0xB2C, 0x144,
+    0x444, 0xA44, 0xB46, 0x148, 0x448, 0xA48, 0x14C, 0x44C,
+    0xA4C, 0x152, 0x452, 0xA52, 0x0B0, 0x158, 0x458, 0xA58,
+    0x15D, 0x0B4, 0x104, 0x404, 0xA04, 0xB06, 0x108, 0x408,
+    0xA08, 0x10C, 0x40C, 0xA0C, 0x112, 0x412, 0xA12, 0x0AF,
+    0x118, 0x418, 0xA18, 0x11D, 0x544, 0x504, 0x644, 0x604,
+    0x074, 0x034, 0x073, 0x033, 0x347, 0x307, 0x070, 0x030,
+    0x648, 0x608, 0x348, 0x308, 0x14F, 0x10F, 0x34F, 0x30F,
+    0x08F, 0x08E, 0x151, 0x111, 0x351, 0x311, 0x952, 0x912,
+    0x155, 0x115, 0x355, 0x315, 0x156, 0x116, 0xB56, 0xB16,
+    0x06F, 0x02F, 0x357, 0x317, 0x0FA, 0x0BA, 0x15D, 0x11D,
+    0x0FD, 0x0BD, 0x071, 0x031, 0x035, 0x088, 0x000
+};
+
+#endif // KEYBOARD_LAYOUT_COMPILED
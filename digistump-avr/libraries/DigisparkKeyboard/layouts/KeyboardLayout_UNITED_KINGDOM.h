@@ -0,0 +1,35 @@
+/*
+ * KeyboardLayout_UNITED_KINGDOM.h
+ * Generated by extras/compile_layouts.py from LAYOUT_UNITED_KINGDOM of keylayouts.h - do not edit.
+ * 96 bytes ASCII, 13 bytes dead keys, 64 bytes for 15 other characters.
+ */
+#ifndef KEYBOARD_LAYOUT_COMPILED
+#define KEYBOARD_LAYOUT_COMPILED LAYOUT_UNITED_KINGDOM
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+
+const uint8_t keycodes_ascii[] PROGMEM = {
+    0x2C, 0x5E, 0x5F, 0x31, 0x61, 0x62, 0x64, 0x34, 0x66, 0x67, 0x65, 0x6E, 0x36, 0x2D, 0x37, 0x38,
+    0x27, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x73, 0x33, 0x76, 0x2E, 0x77, 0x78,
+    0x74, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4A, 0x4B, 0x4C, 0x4D, 0x4E, 0x4F, 0x50, 0x51, 0x52,
+    0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x5B, 0x5C, 0x5D, 0x2F, 0x3F, 0x30, 0x63, 0x6D,
+    0x35, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12,
+    0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x6F, 0x7F, 0x70, 0x71, 0x2A
+};
+
+const uint8_t keycodes_deadkey[] PROGMEM = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+const uint16_t keycodes_unicode[] PROGMEM = {
+    0x00A0, 0x00A3, 0x00A6, 0x00AC, 0x00C1, 0x00C9, 0x00CD, 0x00D3,
+    0x00DA, 0x00E1, 0x00E9, 0x00ED, 0x00F3, 0x00FA, 0x20AC, 0xFFFF
+};
+
+const uint16_t keycodes_unicode_data[] PROGMEM = {
+    0x02C, 0x060, 0x0B5, 0x075, 0x0C4, 0x0C8, 0x0CC, 0x0D2,
+    0x0D8, 0x084, 0x088, 0x08C, 0x092, 0x098, 0x0A1, 0x000
+};
+
+#endif // KEYBOARD_LAYOUT_COMPILED
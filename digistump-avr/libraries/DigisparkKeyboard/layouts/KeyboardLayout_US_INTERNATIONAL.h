@@ -0,0 +1,55 @@
+/*
+ * KeyboardLayout_US_INTERNATIONAL.h
+ * Generated by extras/compile_layouts.py from LAYOUT_US_INTERNATIONAL of keylayouts.h - do not edit.
+ * 96 bytes ASCII, 13 bytes dead keys, 364 bytes for 90 other characters.
+ */
+#ifndef KEYBOARD_LAYOUT_COMPILED
+#define KEYBOARD_LAYOUT_COMPILED LAYOUT_US_INTERNATIONAL
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+
+const uint8_t keycodes_ascii[] PROGMEM = {
+    0x2C, 0x5E, 0x74, 0x60, 0x61, 0x62, 0x64, 0x34, 0x66, 0x67, 0x65, 0x6E, 0x36, 0x2D, 0x37, 0x38,
+    0x27, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x73, 0x33, 0x76, 0x2E, 0x77, 0x78,
+    0x5F, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4A, 0x4B, 0x4C, 0x4D, 0x4E, 0x4F, 0x50, 0x51, 0x52,
+    0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x5B, 0x5C, 0x5D, 0x2F, 0x31, 0x30, 0x63, 0x6D,
+    0x35, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12,
+    0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x6F, 0x71, 0x70, 0x35, 0x2A
+};
+
+const uint8_t keycodes_deadkey[] PROGMEM = {
+    0x34, 0x00, 0x00, 0x63, 0x00, 0x00, 0x35, 0x00, 0x00, 0x74, 0x00, 0x75, 0x00
+};
+
+const uint16_t keycodes_unicode[] PROGMEM = {
+    0x00A0, 0x00A1, 0x00A2, 0x00A3, 0x00A4, 0x00A5, 0x00A6, 0x00A7,
+    0x00A8, 0x00A9, 0x00AB, 0x00AC, 0x00AE, 0x00B0, 0x00B2, 0x00B3,
+    0x00B4, 0x00B5, 0x00B6, 0x00B9, 0x00BB, 0x00BC, 0x00BD, 0x00BE,
+    0x00BF, 0x00C0, 0x00C1, 0x00C2, 0x00C3, 0x00C4, 0x00C5, 0x00C6,
+    0x00C7, 0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CD, 0x00CE,
+    0x00CF, 0x00D0, 0x00D1, 0x00D2, 0x00D3, 0x00D4, 0x00D5, 0x00D6,
+    0x00D7, 0x00D8, 0x00D9, 0x00DA, 0x00DB, 0x00DC, 0x00DD, 0x00DE,
+    0x00DF, 0x00E0, 0x00E1, 0x00E2, 0x00E3, 0x00E4, 0x00E5, 0x00E6,
+    0x00E7, 0x00E8, 0x00E9, 0x00EA, 0x00EB, 0x00EC, 0x00ED, 0x00EE,
+    0x00EF, 0x00F0, 0x00F1, 0x00F2, 0x00F3, 0x00F4, 0x00F5, 0x00F6,
+    0x00F7, 0x00F8, 0x00F9, 0x00FA, 0x00FB, 0x00FC, 0x00FD, 0x00FE,
+    0x00FF, 0x20AC, 0xFFFF
+};
+
+const uint16_t keycodes_unicode_data[] PROGMEM = {
+    0x02C, 0x09E, 0x0C6, 0x0E1, 0x0A1, 0x0AD, 0x0F1, 0x0D6,
+    0x0F4, 0x086, 0x0AF, 0x0B1, 0x095, 0x0F3, 0x09F, 0x0A0,
+    0x0B4, 0x090, 0x0B3, 0x0DE, 0x0B0, 0x0A3, 0x0A4, 0x0A5,
+    0x0B8, 0x744, 0x0C4, 0x444, 0xC44, 0x0D4, 0x0DA, 0x0DD,
+    0x0F6, 0x748, 0x0C8, 0x448, 0xA48, 0x74C, 0x0CC, 0x44C,
+    0xA4C, 0x0C7, 0x0D1, 0x752, 0x0D2, 0x452, 0xC52, 0x0D3,
+    0x0AE, 0x0CF, 0x758, 0x0D8, 0x458, 0x0DC, 0x15C, 0x0D7,
+    0x096, 0x704, 0x084, 0x404, 0xC04, 0xA04, 0x09A, 0x09D,
+    0x0B6, 0x708, 0x108, 0x408, 0xA08, 0x70C, 0x08C, 0x40C,
+    0xA0C, 0x087, 0x091, 0x712, 0x092, 0x412, 0xC12, 0x093,
+    0x0EE, 0x08F, 0x718, 0x098, 0x418, 0x09C, 0x11C, 0x097,
+    0xA1C, 0x0A2, 0x000
+};
+
+#endif // KEYBOARD_LAYOUT_COMPILED
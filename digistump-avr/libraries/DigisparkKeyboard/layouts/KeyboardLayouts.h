@@ -0,0 +1,54 @@
+/*
+ * KeyboardLayouts.h
+ * Generated by extras/compile_layouts.py - do not edit.
+ * Includes the compiled table of the LAYOUT_* defined before including DigiKeyboard.h.
+ */
+#if defined(LAYOUT_US_INTERNATIONAL)
+#include "KeyboardLayout_US_INTERNATIONAL.h"
+#elif defined(LAYOUT_GERMAN)
+#include "KeyboardLayout_GERMAN.h"
+#elif defined(LAYOUT_GERMAN_MAC)
+#include "KeyboardLayout_GERMAN_MAC.h"
+#elif defined(LAYOUT_CANADIAN_FRENCH)
+#include "KeyboardLayout_CANADIAN_FRENCH.h"
+#elif defined(LAYOUT_UNITED_KINGDOM)
+#include "KeyboardLayout_UNITED_KINGDOM.h"
+#elif defined(LAYOUT_FINNISH)
+#include "KeyboardLayout_FINNISH.h"
+#elif defined(LAYOUT_FRENCH)
+#include "KeyboardLayout_FRENCH.h"
+#elif defined(LAYOUT_FRENCH_BELGIAN)
+#include "KeyboardLayout_FRENCH_BELGIAN.h"
+#elif defined(LAYOUT_DANISH)
+#include "KeyboardLayout_DANISH.h"
+#elif defined(LAYOUT_NORWEGIAN)
+#include "KeyboardLayout_NORWEGIAN.h"
+#elif defined(LAYOUT_SWEDISH)
+#include "KeyboardLayout_SWEDISH.h"
+#elif defined(LAYOUT_SPANISH)
+#include "KeyboardLayout_SPANISH.h"
+#elif defined(LAYOUT_SPANISH_LATIN_AMERICA)
+#include "KeyboardLayout_SPANISH_LATIN_AMERICA.h"
+#elif defined(LAYOUT_PORTUGUESE)
+#include "KeyboardLayout_PORTUGUESE.h"
+#elif defined(LAYOUT_ITALIAN)
+#include "KeyboardLayout_ITALIAN.h"
+#elif defined(LAYOUT_PORTUGUESE_BRAZILIAN)
+#include "KeyboardLayout_PORTUGUESE_BRAZILIAN.h"
+#elif defined(LAYOUT_SWISS_GERMAN)
+#include "KeyboardLayout_SWISS_GERMAN.h"
+#elif defined(LAYOUT_SWISS_FRENCH)
+#include "KeyboardLayout_SWISS_FRENCH.h"
+#elif defined(LAYOUT_IRISH)
+#include "KeyboardLayout_IRISH.h"
+#elif defined(LAYOUT_ICELANDIC)
+#include "KeyboardLayout_ICELANDIC.h"
+#elif defined(LAYOUT_TURKISH)
+#include "KeyboardLayout_TURKISH.h"
+#elif defined(LAYOUT_CZECH)
+#include "KeyboardLayout_CZECH.h"
+#elif defined(LAYOUT_SERBIAN_LATIN_ONLY)
+#include "KeyboardLayout_SERBIAN_LATIN_ONLY.h"
+#else
+#include "KeyboardLayout_US_ENGLISH.h"
+#endif
@@ -89,10 +89,11 @@ section at the end of this file).
  * The value is in milliamperes. [It will be divided by two since USB
  * communicates power requirements in units of 2 mA.]
  */
-#define USB_CFG_IMPLEMENT_FN_WRITE      0
+#define USB_CFG_IMPLEMENT_FN_WRITE      1
 /* Set this to 1 if you want usbFunctionWrite() to be called for control-out
  * transfers. Set it to 0 if you don't need it and want to save a couple of
  * bytes.
+ * DigiKeyboard needs it for the LED output report and the feature report.
  */
 #define USB_CFG_IMPLEMENT_FN_READ       0
 /* Set this to 1 if you need to send control replies which are generated
@@ -164,7 +165,21 @@ section at the end of this file).
  * usbFunctionWrite(). Use the global usbCurrentDataToken and a static variable
  * for each control- and out-endpoint to check for duplicate packets.
  */
+#define USB_CFG_HAVE_STATS              0
+/* define this macro to 1 to count packets, CRC errors, NAKed interrupt-in
+ * polls, bus resets and the longest interrupt latency in the global usbStats
+ * (see usbdrv.h). The host reads them with the vendor request below, which
+ * the driver answers itself. Costs about 16 bytes of RAM.
+ */
+#define USB_CFG_STATS_REQUEST           0x53
+/* bRequest of the vendor IN request that reads usbStats. Must not be used by
+ * usbFunctionSetup().
+ */
 #define USB_CFG_HAVE_MEASURE_FRAME_LENGTH   1
+#define USB_CFG_OSCCAL_TRACKING             1
+/* define this macro to 1 to keep OSCCAL calibrated while the device runs,
+ * see osccal.h. Each measurement disables interrupts for one frame (1 ms).
+ */
 #include "osccal.h"
 /* define this macro to 1 if you want the function usbMeasureFrameLength()
  * compiled in. This function can be used to calibrate the AVR's RC oscillator.
@@ -241,7 +256,18 @@ section at the end of this file).
  * HID class is 3, no subclass and protocol required (but may be useful!)
  * CDC class is 2, use subclass 2 and protocol 1 for ACM
  */
-#define USB_CFG_HID_REPORT_DESCRIPTOR_LENGTH    35
+#define DIGIKEYBOARD_FEATURE_REPORT_SIZE        0
+/* Size of the vendor specific feature report, which the host can send to the
+ * device by SET_REPORT (e.g. hidraw on Linux, HidD_SetFeature() on Windows).
+ * 0 for none. With a feature report, the reports get IDs: 1 for the keyboard
+ * and LEDs, 2 for the feature report, which is in its own collection, so it
+ * is not owned by the keyboard driver of the host.
+ */
+#if DIGIKEYBOARD_FEATURE_REPORT_SIZE > 0
+#define USB_CFG_HID_REPORT_DESCRIPTOR_LENGTH    78
+#else
+#define USB_CFG_HID_REPORT_DESCRIPTOR_LENGTH    53
+#endif
 /* Define this to the length of the HID report descriptor, if you implement
  * an HID device. Otherwise don't define it or define it to 0.
  * If you use this define, you must add a PROGMEM character array named
@@ -34,6 +34,12 @@ uchar       usbTxBuf[USB_BUFSIZE];/* data to transmit with next IN, free if usbT
 #if USB_COUNT_SOF
 volatile uchar  usbSofCount;    /* incremented by assembler module every SOF */
 #endif
+#if USB_STATS_COUNT_NAKS
+uchar       usbIntrNakCount;    /* incremented by assembler module on every NAKed interrupt-in poll */
+#endif
+#if USB_CFG_HAVE_STATS && USB_CFG_CHECK_CRC
+uchar       usbCrcErrorCount;   /* incremented by assembler module on every dropped packet */
+#endif
 #if USB_CFG_HAVE_INTRIN_ENDPOINT && !USB_CFG_SUPPRESS_INTR_CODE
 usbTxStatus_t  usbTxStatus1;
 #   if USB_CFG_HAVE_INTRIN_ENDPOINT3
@@ -51,6 +57,13 @@ uchar        usbMsgFlags;    /* flag values see USB_FLG_* */
 
 #define USB_FLG_USE_USER_RW     (1<<7)
 
+#if USB_CFG_HAVE_STATS
+usbStats_t          usbStats;
+#define USB_STATS_INC(counter)  usbStats.counter++
+#else
+#define USB_STATS_INC(counter)
+#endif
+
 /*
 optimizing hints:
 - do not post/pre inc/dec integer values in operations
@@ -238,6 +251,7 @@ char    i;
     }while(--i > 0);            /* loop control at the end is 2 bytes shorter than at beginning */
     usbCrc16Append(&txStatus->buffer[1], len);
     txStatus->len = len + 4;    /* len must be given including sync byte */
+    USB_STATS_INC(txPackets);
     DBG2(0x21 + (((int)txStatus >> 3) & 3), txStatus->buffer, len + 3);
 }
 
@@ -420,6 +434,22 @@ skipMsgPtrAssignment:
 
 /* ------------------------------------------------------------------------- */
 
+#if USB_CFG_HAVE_STATS
+extern unsigned int maxInterruptLatency(void);  /* of the Arduino core */
+
+/* usbStatsSetup() answers the vendor request USB_CFG_STATS_REQUEST with the
+ * usbStats structure.
+ */
+static inline usbMsgLen_t usbStatsSetup(void)
+{
+    usbStats.maxIrqLatency = maxInterruptLatency();
+    usbMsgPtr = (usbMsgPtr_t)&usbStats;
+    return sizeof(usbStats);
+}
+#endif
+
+/* ------------------------------------------------------------------------- */
+
 /* usbProcessRx() is called for every message received by the interrupt
  * routine. It distinguishes between SETUP and DATA packets and processes
  * them accordingly.
@@ -450,6 +480,12 @@ static inline void usbProcessRx(uchar *data, uchar len)
         usbMsgFlags = 0;
         uchar type = rq->bmRequestType & USBRQ_TYPE_MASK;
         if(type != USBRQ_TYPE_STANDARD){    /* standard requests are handled by driver */
+#if USB_CFG_HAVE_STATS
+            if(type == USBRQ_TYPE_VENDOR && rq->bRequest == USB_CFG_STATS_REQUEST &&
+               (rq->bmRequestType & USBRQ_DIR_MASK) == USBRQ_DIR_DEVICE_TO_HOST){
+                replyLen = usbStatsSetup();
+            }else
+#endif
             replyLen = usbFunctionSetup(data);
         }else{
             replyLen = usbDriverSetup(rq);
@@ -541,6 +577,7 @@ uchar       len;
     if(len <= 8){           /* valid data packet */
         usbCrc16Append(&usbTxBuf[1], len);
         len += 4;           /* length including sync byte */
+        USB_STATS_INC(txPackets);
         if(len < 12)        /* a partial package identifies end of message */
             usbMsgLen = USB_NO_MSG;
     }else{
@@ -568,6 +605,39 @@ uchar           isReset = !notResetState;
 
 /* ------------------------------------------------------------------------- */
 
+#if USB_CFG_HAVE_STATS
+/* folds the 8 bit counts of the assembler module into usbStats, often enough
+ * since there is at most one packet per frame
+ */
+static inline void usbStatsUpdate(uchar notResetState)
+{
+static uchar    wasReset;
+uchar           isReset = !notResetState;
+
+    if(isReset && !wasReset)
+        usbStats.resets++;
+    wasReset = isReset;
+#if USB_STATS_COUNT_NAKS
+    {
+        static uchar lastCount;
+        uchar count = usbIntrNakCount;
+        usbStats.intrNaks += (uchar)(count - lastCount);
+        lastCount = count;
+    }
+#endif
+#if USB_CFG_CHECK_CRC
+    {
+        static uchar lastCount;
+        uchar count = usbCrcErrorCount;
+        usbStats.crcErrors += (uchar)(count - lastCount);
+        lastCount = count;
+    }
+#endif
+}
+#endif
+
+/* ------------------------------------------------------------------------- */
+
 USB_PUBLIC void usbPoll(void)
 {
 schar   len;
@@ -581,6 +651,7 @@ uchar   i;
  * retries must be handled on application level.
  * unsigned crc = usbCrc16(buffer + 1, usbRxLen - 3);
  */
+        USB_STATS_INC(rxPackets);
         usbProcessRx(usbRxBuf + USB_BUFSIZE + 1 - usbInputBufOffset, len);
 #if USB_CFG_HAVE_FLOWCONTROL
         if(usbRxLen > 0)    /* only mark as available if not inactivated */
@@ -606,6 +677,12 @@ uchar   i;
     DBG1(0xff, 0, 0);
 isNotReset:
     usbHandleResetHook(i);
+#if USB_CFG_HAVE_STATS
+    usbStatsUpdate(i);
+#endif
+#ifdef USB_POLL_HOOK
+    USB_POLL_HOOK();    /* e.g. osccalTrack() of osccal.c */
+#endif
 }
 
 /* ------------------------------------------------------------------------- */
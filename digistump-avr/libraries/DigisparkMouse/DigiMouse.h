@@ -9,8 +9,6 @@
  */
 #ifndef __DigiMouse_h__
 #define __DigiMouse_h__
- 
-#define REPORT_SIZE 4
 
 #include <Arduino.h>
 #include <avr/pgmspace.h>
@@ -26,6 +24,13 @@
 #include "oddebug.h"
 #include "usbconfig.h"
 
+// DIGIMOUSE_MODE is selected in usbconfig.h
+#if DIGIMOUSE_MODE == DIGIMOUSE_MODE_RELATIVE
+#define REPORT_SIZE 4 // buttons, X, Y, wheel
+#else
+#define REPORT_SIZE 6 // buttons, X (16 bit), Y (16 bit), wheel
+#endif
+
 static const uchar *rt_usbHidReportDescriptor = NULL;
 static uchar rt_usbHidReportDescriptorSize = 0;
 static const uchar *rt_usbDeviceDescriptor = NULL;
@@ -41,11 +46,20 @@ static uchar rt_usbDeviceDescriptorSize = 0;
 
 typedef uint8_t byte;
 
-/* What was most recently read from the controller */
-static unsigned char last_built_report[REPORT_SIZE];
-
+/*
+ * Movement is accumulated between the reports and sent with the next one, as much as fits.
+ * So the calls of move*() between two polls are coalesced into one report and nothing is lost
+ * if a report saturates, the remainder goes with the following reports.
+ */
+static int16_t pending_x, pending_y, pending_wheel;
+static unsigned char pending_buttons;
 /* What was most recently sent to the host */
-static unsigned char last_sent_report[REPORT_SIZE];
+static unsigned char last_sent_buttons;
+#if DIGIMOUSE_MODE == DIGIMOUSE_MODE_ABSOLUTE
+#define DIGIMOUSE_ABSOLUTE_MAX 32767
+static uint16_t position_x, position_y; // moveTo() and the relative moves change it
+static uint16_t last_sent_x, last_sent_y;
+#endif
 
 uchar		 reportBuffer[REPORT_SIZE];
 
@@ -79,6 +93,27 @@ const PROGMEM unsigned char mouse_usbHidReportDescriptor[] = { /* USB report des
 		(unsigned char) 0x05, (unsigned char) 0x01,										 //		USAGE_PAGE(Generic Desktop)
 		(unsigned char) 0x09, (unsigned char) 0x30,										 //		USAGE(X)
 		(unsigned char) 0x09, (unsigned char) 0x31,										 //		USAGE(Y)
+#if DIGIMOUSE_MODE == DIGIMOUSE_MODE_RELATIVE_16BIT
+		(unsigned char) 0x16, (unsigned char) 0x01, (unsigned char) 0x80,				 //		LOGICAL_MINIMUM (-32767)
+		(unsigned char) 0x26, (unsigned char) 0xff, (unsigned char) 0x7f,				 //		LOGICAL_MAXIMUM (32767)
+		(unsigned char) 0x75, (unsigned char) 0x10,										 //		REPORT_SIZE (16)
+		(unsigned char) 0x95, (unsigned char) 0x02,										 //		REPORT_COUNT (2)
+		(unsigned char) 0x81, (unsigned char) 0x06,										 //		INPUT (Data,Var,Rel)
+#elif DIGIMOUSE_MODE == DIGIMOUSE_MODE_ABSOLUTE
+		(unsigned char) 0x15, (unsigned char) 0x00,										 //		LOGICAL_MINIMUM (0)
+		(unsigned char) 0x26, (unsigned char) 0xff, (unsigned char) 0x7f,				 //		LOGICAL_MAXIMUM (32767)
+		(unsigned char) 0x75, (unsigned char) 0x10,										 //		REPORT_SIZE (16)
+		(unsigned char) 0x95, (unsigned char) 0x02,										 //		REPORT_COUNT (2)
+		(unsigned char) 0x81, (unsigned char) 0x02,										 //		INPUT (Data,Var,Abs)
+#endif
+#if DIGIMOUSE_MODE != DIGIMOUSE_MODE_RELATIVE
+		(unsigned char) 0x09, (unsigned char) 0x38,											//	 Usage (Wheel)
+		(unsigned char) 0x15, (unsigned char) 0x81,										 //		LOGICAL_MINIMUM (-127)
+		(unsigned char) 0x25, (unsigned char) 0x7f,										 //		LOGICAL_MAXIMUM (127)
+		(unsigned char) 0x75, (unsigned char) 0x08,										 //		REPORT_SIZE (8)
+		(unsigned char) 0x95, (unsigned char) 0x01,											//	 Report Count (1),
+		(unsigned char) 0x81, (unsigned char) 0x06,											//	 Input (Data, Variable, Relative)
+#else
 		(unsigned char) 0x15, (unsigned char) 0x81,										 //		LOGICAL_MINIMUM (-127)
 		(unsigned char) 0x25, (unsigned char) 0x7f,										 //		LOGICAL_MAXIMUM (127)
 		(unsigned char) 0x75, (unsigned char) 0x08,										 //		REPORT_SIZE (8)
@@ -87,6 +122,7 @@ const PROGMEM unsigned char mouse_usbHidReportDescriptor[] = { /* USB report des
 		(unsigned char) 0x09, (unsigned char) 0x38,											//	 Usage (Wheel)
 		(unsigned char) 0x95, (unsigned char) 0x01,											//	 Report Count (1),
 		(unsigned char) 0x81, (unsigned char) 0x06,											//	 Input (Data, Variable, Relative)
+#endif
 		(unsigned char) 0xc0,														// END_COLLECTION
 		(unsigned char) 0xc0													 // END_COLLECTION
 };
@@ -124,22 +160,83 @@ const unsigned char usbDescrDevice[] PROGMEM = {		/* USB device descriptor */
 };
 
 
+/*
+ * Take up to aLimit of the pending movement, the rest stays for the next report
+ */
+static int16_t takeMove(int16_t *aPending, int16_t aLimit) {
+	int16_t tMove = *aPending;
+	if (tMove > aLimit) {
+		tMove = aLimit;
+	} else if (tMove < -aLimit) {
+		tMove = -aLimit;
+	}
+	*aPending -= tMove;
+	return tMove;
+}
+
+/*
+ * Add to the pending movement, saturating instead of overflowing
+ */
+static void addMove(int16_t *aPending, int aDelta) {
+	long tSum = (long) *aPending + aDelta;
+	if (tSum > 32767) {
+		tSum = 32767;
+	} else if (tSum < -32767) {
+		tSum = -32767;
+	}
+	*aPending = tSum;
+}
+
 void buildReport(unsigned char *reportBuf) {
+	unsigned char tReport[REPORT_SIZE];
+
+	tReport[0] = pending_buttons;
+	last_sent_buttons = pending_buttons;
+#if DIGIMOUSE_MODE == DIGIMOUSE_MODE_RELATIVE
+	tReport[1] = takeMove(&pending_x, 127);
+	tReport[2] = takeMove(&pending_y, 127);
+	tReport[3] = takeMove(&pending_wheel, 127);
+#else
+#  if DIGIMOUSE_MODE == DIGIMOUSE_MODE_ABSOLUTE
+	uint16_t tX = position_x;
+	uint16_t tY = position_y;
+	last_sent_x = tX;
+	last_sent_y = tY;
+#  else
+	int16_t tX = takeMove(&pending_x, 32767);
+	int16_t tY = takeMove(&pending_y, 32767);
+#  endif
+	// little endian, as HID wants it
+	tReport[1] = tX;
+	tReport[2] = tX >> 8;
+	tReport[3] = tY;
+	tReport[4] = tY >> 8;
+	tReport[5] = takeMove(&pending_wheel, 127);
+#endif
 	if (reportBuf != NULL) {
-		memcpy(reportBuf, last_built_report, REPORT_SIZE);
+		memcpy(reportBuf, tReport, REPORT_SIZE);
 	}
-	
-	memcpy(last_sent_report, last_built_report, REPORT_SIZE); 
+}
+
+/*
+ * True if there is something the host has not yet got
+ */
+bool reportPending() {
+	if (pending_x != 0 || pending_y != 0 || pending_wheel != 0 || pending_buttons != last_sent_buttons) {
+		return true;
+	}
+#if DIGIMOUSE_MODE == DIGIMOUSE_MODE_ABSOLUTE
+	return position_x != last_sent_x || position_y != last_sent_y;
+#else
+	return false;
+#endif
 }
 
 void clearMove() {
-	// because we send deltas in movement, so when we send them, we clear them
-	last_built_report[1] = 0;
-	last_built_report[2] = 0;
-	last_built_report[3] = 0;
-	last_sent_report[1] = 0;
-	last_sent_report[2] = 0;
-	last_sent_report[3] = 0;
+	// forget the movement not yet sent
+	pending_x = 0;
+	pending_y = 0;
+	pending_wheel = 0;
 }
 	
 
@@ -147,6 +244,8 @@ void clearMove() {
 
 
  
+static void digiMouseService(void);
+
 class DigiMouseDevice {
  public:
 	DigiMouseDevice () {
@@ -167,6 +266,7 @@ class DigiMouseDevice {
 		
 		sei();
 		last_report_time = millis();
+		schedulerSetService(digiMouseService, SCHEDULER_USB_INTERVAL_US);
 	}
 	
 
@@ -191,20 +291,23 @@ class DigiMouseDevice {
 		    inhibit reporting forever, only reporting when a change is detected in the report data." */
 		if (idle_rate > 0 && time_since_last_report >= (idle_rate * 4 /* in units of 4ms - usb spec stuff */)) {
 			last_report_time += idle_rate * 4;
+#if DIGIMOUSE_MODE != DIGIMOUSE_MODE_ABSOLUTE
+			// an absolute report would pull the pointer back to our position, whenever another mouse moved it
 			must_report = 1;
+#endif
 		}
 		
-		// if the report has changed, try force an update anyway
-		if (memcmp(last_built_report, last_sent_report, REPORT_SIZE)) {
+		// if something has changed, try force an update anyway
+		if (reportPending()) {
 			must_report = 1;
 		}
 		
 		// if we want to send a report, signal the host computer to ask us for it with a usb 'interrupt'
+		// all moves since the last report go into this one
 		if (must_report) {
 			if (usbInterruptIsReady()) {
 				must_report = 0;
-				buildReport(reportBuffer); // put data into reportBuffer
-				clearMove(); // clear deltas
+				buildReport(reportBuffer); // put data into reportBuffer, takes the pending deltas
 				usbSetInterrupt(reportBuffer, REPORT_SIZE);
 			}
 		}
@@ -212,67 +315,82 @@ class DigiMouseDevice {
 	
 	// delay while updating until we are finished
 	void delay(long milli) {
-		unsigned long last = millis();
-	  while (milli > 0) {
-	    unsigned long now = millis();
-	    milli -= now - last;
-	    last = now;
-	    update();
-	  }
+		if (milli > 0) {
+			schedulerDelay(milli); // update() and the schedulerAdd() tasks
+		}
 	}
 	
-	void moveX(char deltaX)	{
-		if (deltaX == -128) deltaX = -127;
-		last_built_report[1] = *(reinterpret_cast<unsigned char *>(&deltaX));
+	/*
+	 * Relative moves add up until they are sent, see buildReport().
+	 * In DIGIMOUSE_MODE_ABSOLUTE they move the position set by moveTo().
+	 */
+	void moveX(int deltaX)	{
+		move(deltaX, 0, 0);
 	}
 	
-	void moveY(char deltaY) {
-		if (deltaY == -128) deltaY = -127;
-		last_built_report[2] = *(reinterpret_cast<unsigned char *>(&deltaY));
+	void moveY(int deltaY) {
+		move(0, deltaY, 0);
 	}
 	
-	void scroll(char deltaS)	{
-		if (deltaS == -128) deltaS = -127;
-		last_built_report[3] = *(reinterpret_cast<unsigned char *>(&deltaS));	 
+	void scroll(int deltaS)	{
+		addMove(&pending_wheel, deltaS);
 	}
 	
-	void move(char deltaX, char deltaY, char deltaS) {
-		if (deltaX == -128) deltaX = -127;
-		if (deltaY == -128) deltaY = -127;
-		if (deltaS == -128) deltaS = -127;
-		last_built_report[1] = *(reinterpret_cast<unsigned char *>(&deltaX));
-		last_built_report[2] = *(reinterpret_cast<unsigned char *>(&deltaY));
-		last_built_report[3] = *(reinterpret_cast<unsigned char *>(&deltaS));
+	void move(int deltaX, int deltaY, int deltaS) {
+#if DIGIMOUSE_MODE == DIGIMOUSE_MODE_ABSOLUTE
+		moveTo(constrain((long) position_x + deltaX, 0, DIGIMOUSE_ABSOLUTE_MAX),
+				constrain((long) position_y + deltaY, 0, DIGIMOUSE_ABSOLUTE_MAX));
+#else
+		addMove(&pending_x, deltaX);
+		addMove(&pending_y, deltaY);
+#endif
+		addMove(&pending_wheel, deltaS);
 	}
 
-	void move(char deltaX, char deltaY, char deltaS, char buttons) {
-		if (deltaX == -128) deltaX = -127;
-		if (deltaY == -128) deltaY = -127;
-		if (deltaS == -128) deltaS = -127;
-		last_built_report[0] = buttons;
-		last_built_report[1] = *(reinterpret_cast<unsigned char *>(&deltaX));
-		last_built_report[2] = *(reinterpret_cast<unsigned char *>(&deltaY));
-		last_built_report[3] = *(reinterpret_cast<unsigned char *>(&deltaS));
+	void move(int deltaX, int deltaY, int deltaS, unsigned char buttons) {
+		pending_buttons = buttons;
+		move(deltaX, deltaY, deltaS);
 	}
 
+#if DIGIMOUSE_MODE == DIGIMOUSE_MODE_ABSOLUTE
+	/*
+	 * 0 to 32767 is the whole width and height of the screen, whatever its resolution
+	 */
+	void moveTo(uint16_t x, uint16_t y) {
+		position_x = min(x, DIGIMOUSE_ABSOLUTE_MAX);
+		position_y = min(y, DIGIMOUSE_ABSOLUTE_MAX);
+	}
+#endif
+
 	void rightClick(){
-		last_built_report[0] = MOUSEBTN_RIGHT_MASK;
+		pending_buttons = MOUSEBTN_RIGHT_MASK;
 	}
 
 	void leftClick(){
-		last_built_report[0] = MOUSEBTN_LEFT_MASK;
+		pending_buttons = MOUSEBTN_LEFT_MASK;
 	}
 	
 	void middleClick(){
-		last_built_report[0] = MOUSEBTN_MIDDLE_MASK;
+		pending_buttons = MOUSEBTN_MIDDLE_MASK;
 	}
 	
 	void setButtons(unsigned char buttons) {
-		last_built_report[0] = buttons;
+		pending_buttons = buttons;
 	}
 	
+	/*
+	 * A whole report: buttons, X, Y, wheel, axes are 16 bit little endian except in DIGIMOUSE_MODE_RELATIVE
+	 */
 	void setValues(unsigned char values[]) {
-		memcpy(last_built_report, values, REPORT_SIZE);
+		pending_buttons = values[0];
+#if DIGIMOUSE_MODE == DIGIMOUSE_MODE_RELATIVE
+		move((signed char) values[1], (signed char) values[2], (signed char) values[3]);
+#elif DIGIMOUSE_MODE == DIGIMOUSE_MODE_ABSOLUTE
+		moveTo(values[1] | (values[2] << 8), values[3] | (values[4] << 8));
+		scroll((signed char) values[5]);
+#else
+		move((int16_t) (values[1] | (values[2] << 8)), (int16_t) (values[3] | (values[4] << 8)), (signed char) values[5]);
+#endif
 	}
 	
 	//private: TODO: Make friend?
@@ -282,6 +400,10 @@ class DigiMouseDevice {
 // create the global singleton DigiMouse
 DigiMouseDevice DigiMouse = DigiMouseDevice();
 
+static void digiMouseService(void) {
+	DigiMouse.update();
+}
+
 
 #ifdef __cplusplus
 extern "C"{
@@ -22,6 +22,10 @@ void loop() {
   DigiMouse.delay(500);
   
   // or DigiMouse.move(X, Y, scroll) works
+  // moves add up until the next report, so a big move is not limited to 127 steps:
+  // it goes with the next reports (or with one, with DIGIMOUSE_MODE_RELATIVE_16BIT in usbconfig.h)
+  DigiMouse.moveX(-300);
+  DigiMouse.delay(500);
   
   // three buttons are the three LSBs of an unsigned char
   DigiMouse.setButtons(1<<0); //left click
@@ -0,0 +1,30 @@
+// DigiMouse absolute positioning: draws a square around the screen center.
+// Set DIGIMOUSE_MODE to DIGIMOUSE_MODE_ABSOLUTE in usbconfig.h of the DigisparkMouse library first.
+// The position goes from 0 to 32767 for the whole width and height of the screen.
+
+#include <DigiMouse.h>
+
+#if DIGIMOUSE_MODE != DIGIMOUSE_MODE_ABSOLUTE
+#error "Set DIGIMOUSE_MODE to DIGIMOUSE_MODE_ABSOLUTE in usbconfig.h of the DigisparkMouse library"
+#endif
+
+void setup() {
+  DigiMouse.begin();
+}
+
+void loop() {
+  DigiMouse.moveTo(12000, 12000);
+  DigiMouse.delay(500);
+  DigiMouse.moveTo(20000, 12000);
+  DigiMouse.delay(500);
+  DigiMouse.moveTo(20000, 20000);
+  DigiMouse.delay(500);
+  DigiMouse.moveTo(12000, 20000);
+  DigiMouse.delay(500);
+
+  // relative moves still work, they move the position
+  for (int i = 0; i < 100; i++) {
+    DigiMouse.moveX(40);
+    DigiMouse.delay(10);
+  }
+}
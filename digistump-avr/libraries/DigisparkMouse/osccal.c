@@ -8,12 +8,15 @@
  */
 
 #include <avr/io.h>
+#include <avr/interrupt.h>
 #include "usbdrv.h" // for usbMeasureFrameLength()
 
 #ifndef uchar
 #define uchar   unsigned char
 #endif
 
+#define OSCCAL_TARGET   ((unsigned)(1499 * (double)F_CPU / 10.5e6 + 0.5))
+
 /* ------------------------------------------------------------------------- */
 /* ------------------------ Oscillator Calibration ------------------------- */
 /* ------------------------------------------------------------------------- */
@@ -27,7 +30,7 @@ void    calibrateOscillator(void)
 {
 uchar       step = 128;
 uchar       trialValue = 0, optimumValue;
-int         x, optimumDev, targetValue = (unsigned)(1499 * (double)F_CPU / 10.5e6 + 0.5);
+int         x, optimumDev, targetValue = OSCCAL_TARGET;
 
     /* do a binary search: */
     do{
@@ -52,6 +55,87 @@ int         x, optimumDev, targetValue = (unsigned)(1499 * (double)F_CPU / 10.5e
     }
     OSCCAL = optimumValue;
 }
+
+#if USB_CFG_OSCCAL_TRACKING
+
+extern unsigned long millis(void);
+extern volatile schar usbRxLen;
+extern volatile uchar usbTxLen;
+
+/* Count of the millis() timer of the Digispark cores (Timer1 on the ATtiny85,
+ * Timer0 on the ATtiny167), 64 cycles per tick: it overflows every 16384
+ * cycles, a bit less than the measured frame (about 16500 cycles at 16.5 MHz).
+ * One overflow during the measurement is kept pending by its flag, a second
+ * one would be lost: the measurement is only started if the count is low
+ * enough for the frame (+ 3 % and a few ticks) to end before that.
+ */
+#if defined(__AVR_ATtiny85__) || defined(__AVR_ATtiny45__) || defined(__AVR_ATtiny25__)
+#define OSCCAL_MILLIS_TCNT      TCNT1
+#elif defined(__AVR_ATtiny167__) || defined(__AVR_ATtiny87__)
+#define OSCCAL_MILLIS_TCNT      TCNT0
+#endif
+#define OSCCAL_MILLIS_TCNT_MAX  (512 - (F_CPU / 1000 * 103 / 100) / 64 - 8)
+
+static unsigned trackTime;
+static int      trackError;     /* 4 times the averaged deviation, units of 7 cycles */
+
+/* Track the oscillator while the device runs: one frame is measured per
+ * OSCCAL_TRACK_INTERVAL and OSCCAL moves by one step at most, so a wrong
+ * measurement that got through can do no harm. See osccal.h.
+ */
+void    osccalTrack(void)
+{
+int         x;
+unsigned    i;
+
+    if((unsigned)millis() - trackTime < OSCCAL_TRACK_INTERVAL)
+        return;
+    /* only on an idle, configured bus: nothing received or waiting to be sent */
+    if(!usbConfiguration || usbRxLen != 0 || !(usbTxLen & 0x10))
+        return;
+#if USB_CFG_HAVE_INTRIN_ENDPOINT && !USB_CFG_SUPPRESS_INTR_CODE
+    /* the host polls a pending interrupt-in report in the measured frame */
+    if(!(usbTxLen1 & 0x10))
+        return;
+#endif
+    trackTime = millis();
+    /* start at a strobe, so that usbMeasureFrameLength() does not wait for one
+     * with interrupts disabled: it then takes one frame */
+    for(i = 3000; i && (USBIN & (1 << USBMINUS)); i--)
+        ;
+    if(!i)      /* no strobe: measuring now would block the interrupts for the timeout */
+        return;
+#ifdef OSCCAL_MILLIS_TCNT
+    if(OSCCAL_MILLIS_TCNT > OSCCAL_MILLIS_TCNT_MAX)
+        return; /* the frame would span two overflows of the millis() timer */
+#endif
+    cli();
+    x = usbMeasureFrameLength() - OSCCAL_TARGET;
+    sei();
+    /* a packet in the frame ends the measurement early */
+    if(x < -(int)(OSCCAL_TARGET / 32) || x > (int)(OSCCAL_TARGET / 32))
+        return;
+    trackError += x - trackError / 4;
+    /* never across the border of the two OSCCAL ranges of version 5 oscillators */
+    if(trackError > 4 * (int)(OSCCAL_TARGET * OSCCAL_TRACK_TOLERANCE / 1000)){
+        if((OSCCAL & 0x7f) != 0){
+            OSCCAL--;
+            trackError = 0;
+        }
+    }else if(trackError < -4 * (int)(OSCCAL_TARGET * OSCCAL_TRACK_TOLERANCE / 1000)){
+        if((OSCCAL & 0x7f) != 0x7f){
+            OSCCAL++;
+            trackError = 0;
+        }
+    }
+}
+
+int     osccalTrackingError(void)
+{
+    return (long)trackError * 2500 / (int)OSCCAL_TARGET;
+}
+
+#endif /* USB_CFG_OSCCAL_TRACKING */
 /*
 Note: This calibration algorithm may try OSCCAL values of up to 192 even if
 the optimum value is far below 192. It may therefore exceed the allowed clock
@@ -27,6 +27,37 @@ extern void calibrateOscillator(void);
 #endif
 #define USB_RESET_HOOK(resetStarts)  if(!resetStarts){cli(); calibrateOscillator(); sei();}
 
+/*
+With USB_CFG_OSCCAL_TRACKING 1 in usbconfig.h the calibration is kept up to date
+while the device runs: the RC oscillator drifts with temperature and supply
+voltage. Every OSCCAL_TRACK_INTERVAL ms usbPoll() calls osccalTrack(), which
+measures one frame with usbMeasureFrameLength() while the bus is idle and
+nudges OSCCAL by 1 when the averaged deviation exceeds OSCCAL_TRACK_TOLERANCE
+(1/1000 of the frame length). Measurements disturbed by USB traffic are
+discarded. The keep-alive strobes are read from the D- pin, so this works with
+the interrupt on D+ as well.
+Interrupts are disabled for about one frame (1 ms) per measurement: a USB
+packet in that frame is retried by the host, a byte received by a software
+serial port in that time is lost. The frame is slightly longer than an
+overflow period of the millis() timer, so a measurement is skipped when it
+would span two overflows: millis() and micros() lose nothing.
+osccalTrackingError() returns the averaged deviation in 1/100 %, positive
+when the clock is too fast.
+*/
+#ifndef OSCCAL_TRACK_INTERVAL
+#define OSCCAL_TRACK_INTERVAL       2000
+#endif
+#ifndef OSCCAL_TRACK_TOLERANCE
+#define OSCCAL_TRACK_TOLERANCE      4
+#endif
+#if USB_CFG_OSCCAL_TRACKING
+#ifndef __ASSEMBLER__
+extern void osccalTrack(void);
+extern int  osccalTrackingError(void);
+#endif
+#define USB_POLL_HOOK()  osccalTrack()
+#endif
+
 /*
 This routine is an alternative to the continuous synchronization described
 in osctune.h.
@@ -164,7 +164,21 @@ section at the end of this file).
  * usbFunctionWrite(). Use the global usbCurrentDataToken and a static variable
  * for each control- and out-endpoint to check for duplicate packets.
  */
+#define USB_CFG_HAVE_STATS              0
+/* define this macro to 1 to count packets, CRC errors, NAKed interrupt-in
+ * polls, bus resets and the longest interrupt latency in the global usbStats
+ * (see usbdrv.h). The host reads them with the vendor request below, which
+ * the driver answers itself. Costs about 16 bytes of RAM.
+ */
+#define USB_CFG_STATS_REQUEST           0x53
+/* bRequest of the vendor IN request that reads usbStats. Must not be used by
+ * usbFunctionSetup().
+ */
 #define USB_CFG_HAVE_MEASURE_FRAME_LENGTH   1
+#define USB_CFG_OSCCAL_TRACKING             1
+/* define this macro to 1 to keep OSCCAL calibrated while the device runs,
+ * see osccal.h. Each measurement disables interrupts for one frame (1 ms).
+ */
 #include "osccal.h"
 /* define this macro to 1 if you want the function usbMeasureFrameLength()
  * compiled in. This function can be used to calibrate the AVR's RC oscillator.
@@ -241,7 +255,20 @@ section at the end of this file).
  * HID class is 3, no subclass and protocol required (but may be useful!)
  * CDC class is 2, use subclass 2 and protocol 1 for ACM
  */
+#define DIGIMOUSE_MODE_RELATIVE         0   /* X, Y and wheel of 8 bit, -127 to 127 per report */
+#define DIGIMOUSE_MODE_RELATIVE_16BIT   1   /* X and Y of 16 bit, -32767 to 32767 per report */
+#define DIGIMOUSE_MODE_ABSOLUTE         2   /* X and Y position, 0 to 32767 over the whole screen */
+#define DIGIMOUSE_MODE                  DIGIMOUSE_MODE_RELATIVE
+/* The report of DigiMouse. It must be selected here, since the length of its
+ * descriptor goes into the configuration descriptor built by usbdrv.c.
+ */
+#if DIGIMOUSE_MODE == DIGIMOUSE_MODE_RELATIVE_16BIT
+#define USB_CFG_HID_REPORT_DESCRIPTOR_LENGTH    64
+#elif DIGIMOUSE_MODE == DIGIMOUSE_MODE_ABSOLUTE
+#define USB_CFG_HID_REPORT_DESCRIPTOR_LENGTH    63
+#else
 #define USB_CFG_HID_REPORT_DESCRIPTOR_LENGTH    56
+#endif
 /* Define this to the length of the HID report descriptor, if you implement
  * an HID device. Otherwise don't define it or define it to 0.
  * If you use this define, you must add a PROGMEM character array named
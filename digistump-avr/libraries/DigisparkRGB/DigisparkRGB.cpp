@@ -1,6 +1,7 @@
 #include <avr/io.h>
 #include <util/delay.h>
 #include <avr/interrupt.h>
+#include <avr/pgmspace.h>
 
 #include "DigisparkRGB.h"
 #include "Arduino.h"
@@ -21,6 +22,43 @@
 unsigned char DigisparkPWMcompare[3]; 
 volatile unsigned char DigisparkPWMcompbuff[3];
 
+/*
+  Hardware mode, DigisparkRGBBegin(redPin, greenPin, bluePin): the channels on a
+  PWM pin (0, 1 and 4 on the Digispark) are plain analogWrite() outputs, no
+  interrupt at all. Only the channels on other pins are software driven, by a
+  pulse density modulation in the Timer0 overflow interrupt: the other PORTB
+  pins are left alone. Timer0 runs at the full clock, like in the software
+  mode, so the interrupt comes at about 64 kHz and even a duty of 1/256
+  repeats at 250 Hz, without visible flicker.
+*/
+static unsigned char RgbHwMode = 0;
+static unsigned char RgbPin[3];
+static unsigned char RgbSoftBit[3];           // PORTB bit of a software channel, 0 for a hardware one
+static unsigned char RgbSoftMask = 0;
+static volatile unsigned char RgbSoftDuty[3];
+static unsigned char RgbSoftAcc[3];
+static unsigned char RgbGamma = 0;
+
+// 8-bit input to LED duty cycle, gamma 2.2
+static const unsigned char RgbGammaTbl[256] PROGMEM = {
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,
+    1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+    3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,
+    6,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  11,  11,  11,  12,
+   12,  13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,
+   20,  20,  21,  22,  22,  23,  23,  24,  25,  25,  26,  26,  27,  28,  28,  29,
+   30,  30,  31,  32,  33,  33,  34,  35,  35,  36,  37,  38,  39,  39,  40,  41,
+   42,  43,  43,  44,  45,  46,  47,  48,  49,  49,  50,  51,  52,  53,  54,  55,
+   56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,
+   73,  74,  75,  76,  77,  78,  79,  81,  82,  83,  84,  85,  87,  88,  89,  90,
+   91,  93,  94,  95,  97,  98,  99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+  113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+  137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+  163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+  192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+  223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255
+};
+
 void DigisparkRGBBegin() {                
 
   pinMode(2, OUTPUT); 
@@ -57,8 +95,55 @@ void DigisparkRGBBegin() {
   sei(); 
 }
 
+void DigisparkRGBBegin(unsigned char redPin, unsigned char greenPin, unsigned char bluePin) {
+  RgbPin[0] = redPin;
+  RgbPin[1] = greenPin;
+  RgbPin[2] = bluePin;
+  RgbSoftMask = 0;
+  for (unsigned char ch = 0; ch < 3; ch++) {
+    RgbSoftDuty[ch] = 0;
+    RgbSoftAcc[ch] = 0;
+    if (digitalPinToTimer(RgbPin[ch]) != NOT_ON_TIMER) {
+      RgbSoftBit[ch] = 0;
+      analogWrite(RgbPin[ch], 0);
+    } else {
+      RgbSoftBit[ch] = digitalPinToBitMask(RgbPin[ch]);
+      RgbSoftMask |= RgbSoftBit[ch];
+      pinMode(RgbPin[ch], OUTPUT);
+      digitalWrite(RgbPin[ch], LOW);
+    }
+  }
+  RgbGamma = 1;
+  RgbHwMode = 1;
+
+  if (RgbSoftMask) {
+    // keep the PWM mode of Timer0 (pins 0 and 1), only speed it up to the full clock
+    TCCR0B = (TCCR0B & ~((1 << CS02) | (1 << CS01) | (1 << CS00))) | (1 << CS00);
+#ifdef TIFR
+    TIFR = (1 << TOV0);           // clear interrupt flag
+#endif
+#ifdef TIMSK
+    TIMSK |= (1 << TOIE0);        // enable overflow interrupt
+#endif
+  }
+}
+
+void DigisparkRGBGamma(unsigned char on) {
+  RgbGamma = on;
+}
+
 void DigisparkRGB(int pin,int value){
-	DigisparkPWMcompbuff[pin] = value;
+	if (pin < 0 || pin > 2) return;
+	if (value < 0) value = 0;
+	if (value > 255) value = 255;
+	if (RgbGamma) value = pgm_read_byte(&RgbGammaTbl[value]);
+	if (!RgbHwMode) {
+		DigisparkPWMcompbuff[pin] = value;
+	} else if (RgbSoftBit[pin]) {
+		RgbSoftDuty[pin] = value;
+	} else {
+		analogWrite(RgbPin[pin], value);
+	}
 }
 
 void DigisparkRGBDelay(int ms) {
@@ -72,6 +157,19 @@ ISR (TIM0_OVF_vect) {
   static unsigned char pinlevelB=PORTB_MASK;
   static unsigned char softcount=0xFF;
 
+  if (RgbHwMode) {
+    // pulse density: on for 'duty' periods out of 256, spread evenly
+    unsigned char on = 0;
+    for (unsigned char ch = 0; ch < 3; ch++) {
+      unsigned char acc = RgbSoftAcc[ch];
+      unsigned char duty = RgbSoftDuty[ch];
+      RgbSoftAcc[ch] = acc + duty;
+      if ((unsigned char)(acc + duty) < acc || duty == 255) on |= RgbSoftBit[ch];
+    }
+    PORTB = (PORTB & ~RgbSoftMask) | on;
+    return;
+  }
+
   PORTB = pinlevelB;            // update outputs
   
   if(++softcount == 0){         // increment modulo 256 counter and update
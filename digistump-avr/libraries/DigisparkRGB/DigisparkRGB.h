@@ -8,7 +8,11 @@
 
 
 void DigisparkRGBBegin();
+void DigisparkRGBBegin(unsigned char redPin, unsigned char greenPin, unsigned char bluePin);
+void DigisparkRGBGamma(unsigned char on);
 void DigisparkRGBDelay(int ms);
+// Set channel 0 (red), 1 (green) or 2 (blue) to 0..255, other channels are ignored.
+// The channel is not a pin number, the pins are given to DigisparkRGBBegin().
 void DigisparkRGB(int pin,int value);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,50 @@
+#include <DigisparkRGB.h>
+/*
+ Digispark RGB, hardware PWM
+
+ Same fade as the DigisparkRGB example, but red (pin 0) and green (pin 1) use the
+ hardware PWM of Timer0: only blue (pin 2, no PWM) is software driven. Wire blue
+ to pin 4 instead, DigisparkRGBBegin(0, 1, 4), and no interrupt is used at all.
+
+ The input is gamma corrected (DigisparkRGBGamma(false) to turn it off) and
+ millis()/delay() are not affected.
+
+ This example code is in the public domain.
+ */
+byte RED = 0;
+byte BLUE = 2;
+byte GREEN = 1;
+byte COLORS[] = {RED, BLUE, GREEN};
+
+// the setup routine runs once when you press reset:
+void setup() { 
+  DigisparkRGBBegin(0, 1, 2); // pins of the red, green and blue channels
+} 
+
+
+void loop() {
+  //direction: up = true, down = false
+  static boolean dir = true;
+  static int i = 0;
+
+  fade(COLORS[i%3], dir);
+  i++;
+  dir = !dir;
+}
+
+void fade(byte Led, boolean dir) {
+  int i;
+  
+  //if fading up
+  if (dir) {
+    for (i = 0; i < 256; i++) {
+      DigisparkRGB(Led, i);
+      delay(10);
+    }
+  } else {
+    for (i = 255; i >= 0; i--)  {
+      DigisparkRGB(Led, i);
+      delay(10);
+    }
+  }
+}
@@ -78,7 +78,7 @@
 *************************************************************************/
 /* For an easy Library Version Management */
 #define RC_SEQ_LIB_VERSION		2
-#define RC_SEQ_LIB_REVISION		1
+#define RC_SEQ_LIB_REVISION		2
 
 #define STR(s)				#s
 #define MAKE_TEXT_VER_REV(Ver,Rev)	(char*)(STR(Ver)"."STR(Rev))
@@ -98,7 +98,10 @@
 #define KBD_PULSE_CHECK_MS            	50L
 
 /* Free servo Indicator */
-#define NO_SEQ_LINE                    255
+#define NO_SEQ                         255
+
+/* No more line to start in the sequence */
+#define NO_START_MS                    0xFFFFFFFF
 
 /* Free Position Indicator */
 #define NO_POS                         255
@@ -106,8 +109,8 @@
 /* The macro below computes how many refresh to perform while a duration in ms */
 #define REFRESH_NB(DurationMs)         ((DurationMs)/REFRESH_INTERVAL_MS)
 
-/* The motion goes from StartInDegrees to EndInDegrees and will take MotionDurationMs in ms */
-#define STEP_IN_DEGREES_PER_REFRESH(StartInDegrees,EndInDegrees,MotionDurationMs) (EndInDegrees-StartInDegrees)/REFRESH_NB(MotionDurationMs)
+/* Motion progress is a Q16 fraction (0 -> 0xFFFF), eased positions are Q15 fractions (0 -> 32768) */
+#define EASE_ONE                       32768L
 /* A set of Macros to read an (u)int8_t (Byte), an (u)int16_t (Word) in  program memory (Flash memory) */
 #define PGM_READ_8(FlashAddr)		pgm_read_byte(&(FlashAddr))
 #define PGM_READ_16(FlashAddr)		pgm_read_word(&(FlashAddr))
@@ -139,9 +142,11 @@ typedef struct {
   int8_t   CmdIdx;
   int8_t   Pos;
   uint32_t StartChronoMs;
+  uint32_t ScanFromMs;     /* Lines starting before this offset are already started */
+  uint32_t NextStartMs;    /* Offset of the next line to start, NO_START_MS if none */
   void    *TableOrShortAction;
   uint8_t  SequenceLength;
-  uint8_t  ShortActionMap;
+  uint8_t  MotionNb;       /* Servo motions of this sequence in progress */
 #ifdef RC_SEQ_CONTROL_SUPPORT
   uint8_t(*Control)(uint8_t Action, uint8_t SeqIdx);
 #endif
@@ -169,7 +174,12 @@ typedef struct {
 typedef struct {
   SoftRcPulseOut Motor;
   uint16_t       RefreshNb;       /* Used to store the number of refresh to perform during a servo motion (if not 0 -> Motion in progress) */
-  uint8_t        SeqLineInProgress;
+  uint16_t       Progress;        /* Q16 fraction of the motion already done */
+  uint16_t       ProgressStep;    /* Q16 progress per refresh (the only division is done at the start of the motion) */
+  uint8_t        StartInDegrees;
+  uint8_t        EndInDegrees;
+  uint8_t        Ease;            /* RC_SEQ_EASE_xxx */
+  uint8_t        SeqIdx;          /* Sequence owning the motion in progress, NO_SEQ if none */
 }ServoSt_t;
 #endif
 /*************************************************************************
@@ -181,23 +191,43 @@ static uint8_t ServoNb;
 static uint8_t CmdSignalNb;
 static RcCmdSt_t          RcChannel[RC_CMD_MAX_NB];
 #endif
-#ifdef RC_SEQ_WITH_STATIC_MEM_ALLOC_SUPPORT
+/* Static allocation only: the servo objects need their constructor, which malloc() does not call */
 #ifdef RC_SEQ_WITH_SOFT_RC_PULSE_OUT_SUPPORT
 static ServoSt_t          Servo[SERVO_MAX_NB];
 #endif
 static CmdSequenceSt_t    CmdSequence[SEQUENCE_MAX_NB];
-#else
-#ifdef RC_SEQ_WITH_SOFT_RC_PULSE_OUT_SUPPORT
-static ServoSt_t          *Servo = NULL;
+#ifdef RC_SEQ_WITH_PPM_IN_SUPPORT
+static SoftRcPpmIn        PpmIn;
+static uint8_t            PpmInChNb;
+static uint8_t            PpmInPin;
+static uint8_t            PpmInLastMs;
 #endif
-static CmdSequenceSt_t    *CmdSequence = NULL;
+#ifdef RC_SEQ_WITH_PPM_OUT_SUPPORT
+static SoftRcPpmOut       PpmOut;
+static uint8_t            PpmOutChNb;
 #endif
 /*************************************************************************
 					PRIVATE FUNCTION PROTOTYPES
 *************************************************************************/
 static uint8_t ExecuteSequence(uint8_t CmdIdx, uint8_t Pos);
+static void    ScanSequence(uint8_t Idx, uint32_t ElapsedMs);
+static void    EndOfSequence(uint8_t Idx);
 #ifdef RC_SEQ_WITH_SOFT_RC_PULSE_IN_SUPPORT
 static int8_t GetPos(uint8_t ChIdx, uint16_t PulseWidthUs);
+static void   ProcessPulse(uint8_t ChIdx, uint16_t PulseWidthUs);
+#endif
+#ifdef RC_SEQ_WITH_SOFT_RC_PULSE_OUT_SUPPORT
+static void   ServoWrite(uint8_t Idx, uint16_t Angle);
+static void   StartMotion(uint8_t ServoIdx, const SequenceSt_t *Line, uint8_t SeqIdx);
+static void   UpdateMotion(uint8_t ServoIdx);
+static uint16_t Ease(uint8_t Type, uint16_t Progress);
+
+/* Q15 ease in/out curve: (1 - cos(PI * x)) / 2 for x = 0/32 to 32/32, linearly interpolated between the points */
+static const uint16_t EaseInOutTbl[33] PROGMEM = {
+	0, 79, 315, 705, 1247, 1935, 2761, 3719, 4799, 5990, 7282, 8661, 10114, 11628, 13188, 14778,
+	16384, 17990, 19580, 21140, 22654, 24107, 25486, 26778, 27969, 29049, 30007, 30833, 31521, 32063, 32453, 32689,
+	32768
+};
 #endif
 
 //========================================================================================================================
@@ -211,15 +241,13 @@ void RcSeq_Init(void)
 		RcChannel[ChIdx].Pos.Idx = NO_POS;
 	}
 #endif
-#ifdef RC_SEQ_WITH_STATIC_MEM_ALLOC_SUPPORT
 	for(uint8_t SeqIdx = 0; SeqIdx < SEQUENCE_MAX_NB; SeqIdx++)
 	{
 		CmdSequence[SeqIdx].InProgress = 0;
 		CmdSequence[SeqIdx].TableOrShortAction = NULL;
 		CmdSequence[SeqIdx].SequenceLength = 0;
-		CmdSequence[SeqIdx].ShortActionMap = 0;
+		CmdSequence[SeqIdx].MotionNb = 0;
 	}
-#endif
 #ifdef RC_SEQ_WITH_SOFT_RC_PULSE_IN_SUPPORT
 	TinyPinChange_Init();
 #endif
@@ -243,30 +271,37 @@ char *RcSeq_LibTextVersionRevision(void)
 #ifdef RC_SEQ_WITH_SOFT_RC_PULSE_OUT_SUPPORT
 void RcSeq_DeclareServo(uint8_t Idx, uint8_t DigitalPin)
 {
-#ifdef RC_SEQ_WITH_STATIC_MEM_ALLOC_SUPPORT
 	if(Idx < SERVO_MAX_NB)
 	{
 		Servo[Idx].Motor.attach(DigitalPin);
-		Servo[Idx].SeqLineInProgress = NO_SEQ_LINE;
+		Servo[Idx].RefreshNb = 0;
+		Servo[Idx].SeqIdx = NO_SEQ;
 		if(ServoNb < (Idx + 1)) ServoNb = (Idx + 1);
 	}
-#else
+}
+//========================================================================================================================
+void RcSeq_ServoWrite(uint8_t Idx, uint16_t Angle)
+{
 	if(Idx < SERVO_MAX_NB)
 	{
-		ServoNb++;
-		if(!Servo) Servo = (ServoSt_t*)malloc(sizeof(ServoSt_t));
-		else       Servo = (ServoSt_t*)realloc(Servo, sizeof(ServoSt_t) * ServoNb);
-		Servo[Idx].Motor.attach(DigitalPin);
-		Servo[Idx].SeqLineInProgress = NO_SEQ_LINE;
+	  ServoWrite(Idx, Angle);
 	}
-#endif
 }
+#endif
+#ifdef RC_SEQ_WITH_PPM_OUT_SUPPORT
 //========================================================================================================================
-void RcSeq_ServoWrite(uint8_t Idx, uint16_t Angle)
+void RcSeq_DeclarePpmOutput(uint8_t DigitalPin, uint8_t ChNb)
 {
-	if(Idx < SERVO_MAX_NB)
+	if(ChNb > SERVO_MAX_NB) ChNb = SERVO_MAX_NB;
+	if(PpmOut.attach(DigitalPin, ChNb))
 	{
-	  Servo[Idx].Motor.write(Angle);
+		PpmOutChNb = ChNb;
+		for(uint8_t Idx = 0; Idx < ChNb; Idx++)
+		{
+			Servo[Idx].RefreshNb = 0;
+			Servo[Idx].SeqIdx = NO_SEQ;
+		}
+		if(ServoNb < ChNb) ServoNb = ChNb;
 	}
 }
 #endif
@@ -283,6 +318,15 @@ void RcSeq_DeclareSignal(uint8_t Idx, uint8_t DigitalPin)
 //========================================================================================================================
 boolean RcSeq_SignalTimeout(uint8_t Idx, uint8_t TimeoutMs, uint8_t *State)
 {
+#ifdef RC_SEQ_WITH_PPM_IN_SUPPORT
+	if(Idx < PpmInChNb)
+	{
+		/* No more PPM frame */
+		if((uint8_t)((uint8_t)(millis() & 0x000000FF) - PpmInLastMs) < TimeoutMs) return(0);
+		*State = digitalRead(PpmInPin);
+		return(1);
+	}
+#endif
 	if(Idx < RC_CMD_MAX_NB)
 	{
 		return(RcChannel[Idx].Pulse.timeout(TimeoutMs, State));
@@ -290,6 +334,19 @@ boolean RcSeq_SignalTimeout(uint8_t Idx, uint8_t TimeoutMs, uint8_t *State)
 	return(0);
 }
 //========================================================================================================================
+#ifdef RC_SEQ_WITH_PPM_IN_SUPPORT
+void RcSeq_DeclarePpmSignal(uint8_t DigitalPin, uint8_t ChNb)
+{
+	if(ChNb > RC_CMD_MAX_NB) ChNb = RC_CMD_MAX_NB; /* Extra channels are ignored */
+	if(PpmIn.attach(DigitalPin, ChNb))
+	{
+		PpmInChNb = ChNb;
+		PpmInPin = DigitalPin;
+		PpmInLastMs = (uint8_t)(millis() & 0x000000FF);
+	}
+}
+//========================================================================================================================
+#endif
 void RcSeq_DeclareKeyboardOrStickOrCustom(uint8_t ChIdx, uint8_t Type, uint16_t PulseMinUs, uint16_t PulseMaxUs, const KeyMap_t *KeyMap, uint8_t PosNb)
 {
 	RcChannel[ChIdx].Type = Type;
@@ -315,17 +372,10 @@ void RcSeq_DeclareCommandAndSequence(uint8_t CmdIdx,uint8_t Pos, const SequenceS
 uint8_t  Idx, ServoIdx;
 uint16_t StartInDegrees;
 uint32_t StartMinMs[SERVO_MAX_NB];
-#ifndef RC_SEQ_WITH_STATIC_MEM_ALLOC_SUPPORT
-	if(!CmdSequence) CmdSequence = (CmdSequenceSt_t*)malloc(sizeof(CmdSequenceSt_t));
-	else             CmdSequence = (CmdSequenceSt_t*)realloc(CmdSequence, sizeof(CmdSequenceSt_t) * (SeqNb + 1));
-	Idx = SeqNb;
-	SeqNb++;
-#else
 	for(Idx = 0; Idx < SEQUENCE_MAX_NB; Idx++)
 	{
 		if(!CmdSequence[Idx].TableOrShortAction)
 		{
-#endif
 			CmdSequence[Idx].CmdIdx = CmdIdx;
 			CmdSequence[Idx].Pos = Pos;
 			CmdSequence[Idx].TableOrShortAction = (void*)Table;
@@ -333,12 +383,10 @@ uint32_t StartMinMs[SERVO_MAX_NB];
 #ifdef RC_SEQ_CONTROL_SUPPORT
 			CmdSequence[Idx].Control = Control;
 #endif
-#ifdef RC_SEQ_WITH_STATIC_MEM_ALLOC_SUPPORT
 			SeqNb++;
 			break;
 		}
 	}
-#endif
 	
 #ifdef RC_SEQ_WITH_SOFT_RC_PULSE_OUT_SUPPORT
 	/* Get initial pulse width for each Servo */
@@ -355,7 +403,7 @@ uint32_t StartMinMs[SERVO_MAX_NB];
 			{
 				StartMinMs[ServoIdx] = (uint32_t)PGM_READ_32(Table[Idx].StartMotionOffsetMs);
 				StartInDegrees = (uint16_t)PGM_READ_8(Table[Idx].StartInDegrees);
-				Servo[ServoIdx].Motor.write(StartInDegrees);
+				ServoWrite(ServoIdx, StartInDegrees);
 			}
 		}
 	}
@@ -366,27 +414,21 @@ uint32_t StartMinMs[SERVO_MAX_NB];
 void RcSeq_DeclareCommandAndShortAction(uint8_t CmdIdx, uint8_t Pos, void(*ShortAction)(void))
 {
 uint8_t Idx;
-#ifndef RC_SEQ_WITH_STATIC_MEM_ALLOC_SUPPORT
-	if(!CmdSequence) CmdSequence = (CmdSequenceSt_t*)malloc(sizeof(CmdSequenceSt_t));
-	else             CmdSequence = (CmdSequenceSt_t*)realloc(CmdSequence, sizeof(CmdSequenceSt_t) * (SeqNb + 1));
-	Idx = SeqNb;
-	SeqNb++;
-#else
 	for(Idx = 0; Idx < SEQUENCE_MAX_NB; Idx++)
 	{
 		if(!CmdSequence[Idx].TableOrShortAction)
 		{
-#endif
 			CmdSequence[Idx].CmdIdx = CmdIdx;
 			CmdSequence[Idx].Pos = Pos;
 			CmdSequence[Idx].TableOrShortAction = (void*)ShortAction;
 			CmdSequence[Idx].SequenceLength = 0;
-#ifdef RC_SEQ_WITH_STATIC_MEM_ALLOC_SUPPORT
+#ifdef RC_SEQ_CONTROL_SUPPORT
+			CmdSequence[Idx].Control = NULL;
+#endif
 			SeqNb++;
 			break;
 		}
 	}
-#endif
 }
 #endif
 
@@ -394,7 +436,7 @@ uint8_t Idx;
 uint8_t RcSeq_LaunchSequence(const SequenceSt_t *Table)
 {
 uint8_t Idx, Ret = 0;
-	for(Idx = 0; Idx < SEQUENCE_MAX_NB; Idx++)
+	for(Idx = 0; Idx < SeqNb; Idx++)
 	{
 		if(CmdSequence[Idx].TableOrShortAction == (void*)Table)
 		{
@@ -409,121 +451,52 @@ void RcSeq_Refresh(void)
 {
 static uint32_t NowMs = millis();
 static uint32_t StartChronoInterPulseMs = millis();
-SequenceSt_t   *SequenceTable;
-void           (*ShortAction)(void);
-int8_t          ShortActionCnt;
-uint8_t         ServoIdx;
-uint32_t        MotionDurationMs, StartOfSeqMs, EndOfSeqMs, Pos;
-uint16_t        StartInDegrees, EndInDegrees;
+uint32_t        ElapsedMs;
 
 #ifdef RC_SEQ_WITH_SOFT_RC_PULSE_IN_SUPPORT
 uint8_t         ChIdx;
-int8_t          CmdPos; /* Shall be signed */
-uint32_t        RcPulseWidthUs;
 
 	/* Asynchronous RC Command acquisition */
 	for(ChIdx = 0; ChIdx < CmdSignalNb; ChIdx++)
 	{
 		if(!RcChannel[ChIdx].Pulse.available()) continue; /* Channel not used or no pulse received */
-		RcPulseWidthUs = RcChannel[ChIdx].Pulse.width_us();
-		CmdPos = GetPos(ChIdx, RcPulseWidthUs);
-//		Serial.print("W=");Serial.print(RcPulseWidthUs);Serial.print(" P=");Serial.println((int)CmdPos);
-		if(CmdPos >= 0)
-		{
-			if(RcChannel[ChIdx].Pos.Idx != CmdPos)
-			{
-				  RcChannel[ChIdx].Pos.Idx = CmdPos;
-				  RcChannel[ChIdx].Pos.StartChronoMs = millis();
-			}	
-			else
-			{
-				  if((millis() - RcChannel[ChIdx].Pos.StartChronoMs) >= ((RcChannel[ChIdx].Type == RC_CMD_STICK)?STICK_PULSE_CHECK_MS:KBD_PULSE_CHECK_MS)) /* Check the Pulse is valid at least for 100 ms or 50 ms */
-				  {
-					  ExecuteSequence(ChIdx, CmdPos);
-					  RcChannel[ChIdx].Pos.Idx = NO_POS;
-				  }
-			}   
-		}
-		else
+		ProcessPulse(ChIdx, RcChannel[ChIdx].Pulse.width_us());
+	}
+#ifdef RC_SEQ_WITH_PPM_IN_SUPPORT
+	/* All the PPM channels at once, from a single pin */
+	if(PpmInChNb && PpmIn.available())
+	{
+		PpmInLastMs = (uint8_t)(millis() & 0x000000FF);
+		for(ChIdx = 0; (ChIdx < PpmInChNb) && (ChIdx < PpmIn.channels()); ChIdx++)
 		{
-			RcChannel[ChIdx].Pos.Idx = NO_POS;
+			ProcessPulse(ChIdx, PpmIn.width_us(ChIdx + 1));
 		}
 	}
+#endif
 #endif
     NowMs = millis();
     if((NowMs - StartChronoInterPulseMs) >= 20UL)
     {
 		/* We arrive here every 20 ms */
-		/* Asynchronous Servo Sequence management */
-		for(int8_t Idx = 0; Idx < SeqNb; Idx++)
+#ifdef RC_SEQ_WITH_SOFT_RC_PULSE_OUT_SUPPORT
+		/* Motions in progress: one step each, whatever the length of the sequence tables */
+		for(uint8_t ServoIdx = 0; ServoIdx < ServoNb; ServoIdx++)
+		{
+			if(Servo[ServoIdx].RefreshNb) UpdateMotion(ServoIdx);
+		}
+#endif
+		/* Asynchronous Servo Sequence management: the tables are only read when a line is due */
+		for(uint8_t Idx = 0; Idx < SeqNb; Idx++)
 		{
 			if(!CmdSequence[Idx].InProgress || !CmdSequence[Idx].SequenceLength) continue;
-			ShortActionCnt = -1;
-			for(int8_t SeqLine = 0; SeqLine < CmdSequence[Idx].SequenceLength; SeqLine++) /* Read all lines of the sequence table: this allows to run several servos simultaneously (not forcibly one after the other) */
+			ElapsedMs = NowMs - CmdSequence[Idx].StartChronoMs;
+			if((CmdSequence[Idx].NextStartMs != NO_START_MS) && (ElapsedMs >= CmdSequence[Idx].NextStartMs))
 			{
-				SequenceTable = (SequenceSt_t *)CmdSequence[Idx].TableOrShortAction;
-				ServoIdx = (int8_t)PGM_READ_8(SequenceTable[SeqLine].ServoIndex);
-#ifdef RC_SEQ_WITH_SHORT_ACTION_SUPPORT
-				if(ServoIdx == 255) /* Not a Servo: it's a short Action to perform only if not already done */
-				{
-					ShortActionCnt++;
-					StartOfSeqMs = CmdSequence[Idx].StartChronoMs + (int32_t)PGM_READ_32(SequenceTable[SeqLine].StartMotionOffsetMs);
-					if( (NowMs >= StartOfSeqMs) && !TST_BIT(CmdSequence[Idx].ShortActionMap, ShortActionCnt) )
-					{
-						ShortAction = (void(*)(void))PGM_READ_16(SequenceTable[SeqLine].ShortAction);
-						ShortAction();
-						SET_BIT(CmdSequence[Idx].ShortActionMap, ShortActionCnt); /* Mark short Action as performed */
-						/* If the last line contains an Action: End of Sequence */
-						if(SeqLine == (CmdSequence[Idx].SequenceLength - 1))
-						{
-							CmdSequence[Idx].InProgress = 0;
-							CmdSequence[Idx].ShortActionMap = 0; /* Mark all Short Action as not performed */
-						}
-					}
-					continue;
-				}
-#endif
-#ifdef RC_SEQ_WITH_SOFT_RC_PULSE_OUT_SUPPORT
-				if(Servo[ServoIdx].RefreshNb && SeqLine != Servo[ServoIdx].SeqLineInProgress)
-				{
-					continue;
-				}
-				StartOfSeqMs = CmdSequence[Idx].StartChronoMs + (int32_t)PGM_READ_32(SequenceTable[SeqLine].StartMotionOffsetMs);
-				MotionDurationMs = (int32_t)PGM_READ_32(SequenceTable[SeqLine].MotionDurationMs);
-				EndOfSeqMs = StartOfSeqMs + MotionDurationMs;
-				if(!Servo[ServoIdx].RefreshNb && Servo[ServoIdx].SeqLineInProgress == NO_SEQ_LINE)
-				{
-					if( (NowMs >= StartOfSeqMs) && (NowMs <= EndOfSeqMs) )
-					{
-						Servo[ServoIdx].SeqLineInProgress = SeqLine;
-						StartInDegrees = (uint16_t)PGM_READ_8(SequenceTable[SeqLine].StartInDegrees);
-						Servo[ServoIdx].RefreshNb = REFRESH_NB(MotionDurationMs);
-						Servo[ServoIdx].Motor.write(StartInDegrees);
-					}
-				}
-				else
-				{
-					/* A sequence line is in progress: update the next position */
-					if(Servo[ServoIdx].RefreshNb) Servo[ServoIdx].RefreshNb--;
-					StartInDegrees = (uint16_t)PGM_READ_8(SequenceTable[SeqLine].StartInDegrees);
-					EndInDegrees = (uint16_t)PGM_READ_8(SequenceTable[SeqLine].EndInDegrees);
-					Pos = (int32_t)EndInDegrees - ((int32_t)Servo[ServoIdx].RefreshNb * STEP_IN_DEGREES_PER_REFRESH((int32_t)StartInDegrees,(int32_t)EndInDegrees,(int32_t)MotionDurationMs)); //For refresh max nb, Pos = StartInDegrees
-					Servo[ServoIdx].Motor.write(Pos);
-					if( !Servo[ServoIdx].RefreshNb )
-					{
-						Servo[ServoIdx].SeqLineInProgress = NO_SEQ_LINE;
-						/* Last servo motion and refresh = 0  ->  End of Sequence */
-						if(SeqLine == (CmdSequence[Idx].SequenceLength - 1))
-						{
-							CmdSequence[Idx].InProgress = 0;
-							CmdSequence[Idx].ShortActionMap = 0; /* Mark all Short Action as not performed */
-#ifdef RC_SEQ_CONTROL_SUPPORT
-							if(CmdSequence[Idx].Control != NULL) CmdSequence[Idx].Control(RC_SEQ_END_OF_SEQ, Idx);
-#endif
-						}
-					}
-				}
-#endif
+				ScanSequence(Idx, ElapsedMs);
+			}
+			if((CmdSequence[Idx].NextStartMs == NO_START_MS) && !CmdSequence[Idx].MotionNb)
+			{
+				EndOfSequence(Idx);
 			}
 		}
 #ifdef RC_SEQ_WITH_SOFT_RC_PULSE_OUT_SUPPORT
@@ -570,11 +543,15 @@ uint8_t Idx, Ret = 0;
 					{
 					  CmdSequence[Idx].InProgress = 1;
 					  CmdSequence[Idx].StartChronoMs = millis();
+					  CmdSequence[Idx].ScanFromMs = 0;
+					  CmdSequence[Idx].NextStartMs = 0;
 					  Ret = 1;
 					}
 #else
 					CmdSequence[Idx].InProgress = 1;
 					CmdSequence[Idx].StartChronoMs = millis();
+					CmdSequence[Idx].ScanFromMs = 0;
+					CmdSequence[Idx].NextStartMs = 0;
 					Ret = 1;
 #endif
 				}
@@ -585,7 +562,161 @@ uint8_t Idx, Ret = 0;
 	return(Ret);
 }
 //========================================================================================================================
+/* Start the lines whose offset is in [ScanFromMs, ElapsedMs] and find the offset of the next line to start */
+static void ScanSequence(uint8_t Idx, uint32_t ElapsedMs)
+{
+const SequenceSt_t *SequenceTable = (const SequenceSt_t *)CmdSequence[Idx].TableOrShortAction;
+uint32_t            OffsetMs, NextStartMs = NO_START_MS;
+uint8_t             ServoIdx;
+
+	for(uint8_t SeqLine = 0; SeqLine < CmdSequence[Idx].SequenceLength; SeqLine++)
+	{
+		OffsetMs = (uint32_t)PGM_READ_32(SequenceTable[SeqLine].StartMotionOffsetMs);
+		if(OffsetMs < CmdSequence[Idx].ScanFromMs) continue; /* Already started */
+		if(OffsetMs > ElapsedMs)
+		{
+			if(OffsetMs < NextStartMs) NextStartMs = OffsetMs;
+			continue;
+		}
+		ServoIdx = PGM_READ_8(SequenceTable[SeqLine].ServoIndex);
+#ifdef RC_SEQ_WITH_SHORT_ACTION_SUPPORT
+		if(ServoIdx == 255) /* Not a Servo: it's a short Action to perform */
+		{
+			void (*ShortAction)(void) = (void(*)(void))PGM_READ_16(SequenceTable[SeqLine].ShortAction);
+			ShortAction();
+			continue;
+		}
+#endif
+#ifdef RC_SEQ_WITH_SOFT_RC_PULSE_OUT_SUPPORT
+		if(ServoIdx < ServoNb) StartMotion(ServoIdx, &SequenceTable[SeqLine], Idx);
+#endif
+	}
+	CmdSequence[Idx].ScanFromMs = ElapsedMs + 1;
+	CmdSequence[Idx].NextStartMs = NextStartMs;
+}
+//========================================================================================================================
+static void EndOfSequence(uint8_t Idx)
+{
+	CmdSequence[Idx].InProgress = 0;
+#ifdef RC_SEQ_CONTROL_SUPPORT
+	if(CmdSequence[Idx].Control != NULL) CmdSequence[Idx].Control(RC_SEQ_END_OF_SEQ, Idx);
+#endif
+}
+//========================================================================================================================
+#ifdef RC_SEQ_WITH_SOFT_RC_PULSE_OUT_SUPPORT
+/* A new line for a servo replaces the motion in progress (if any) */
+static void StartMotion(uint8_t ServoIdx, const SequenceSt_t *Line, uint8_t SeqIdx)
+{
+ServoSt_t *S = &Servo[ServoIdx];
+uint16_t   RefreshNb = REFRESH_NB((uint32_t)PGM_READ_32(Line->MotionDurationMs));
+
+	if(S->RefreshNb && (S->SeqIdx != NO_SEQ)) CmdSequence[S->SeqIdx].MotionNb--;
+	S->StartInDegrees = PGM_READ_8(Line->StartInDegrees);
+	S->EndInDegrees   = PGM_READ_8(Line->EndInDegrees);
+	S->Ease           = PGM_READ_8(Line->Ease);
+	if(!RefreshNb)
+	{
+		/* No duration: go to the end position at once */
+		S->RefreshNb = 0;
+		S->SeqIdx = NO_SEQ;
+		ServoWrite(ServoIdx, S->EndInDegrees);
+		return;
+	}
+	S->RefreshNb    = RefreshNb;
+	S->Progress     = 0;
+	S->ProgressStep = 0xFFFF / RefreshNb;
+	S->SeqIdx       = SeqIdx;
+	CmdSequence[SeqIdx].MotionNb++;
+	ServoWrite(ServoIdx, S->StartInDegrees);
+}
+//========================================================================================================================
+static void UpdateMotion(uint8_t ServoIdx)
+{
+ServoSt_t *S = &Servo[ServoIdx];
+int16_t    Delta = (int16_t)S->EndInDegrees - (int16_t)S->StartInDegrees;
+uint16_t   Pos;
+
+	if(--S->RefreshNb)
+	{
+		S->Progress += S->ProgressStep;
+		Pos = S->StartInDegrees + (int16_t)(((int32_t)Delta * Ease(S->Ease, S->Progress)) / EASE_ONE);
+	}
+	else
+	{
+		/* Last step: exactly on the end position */
+		Pos = S->EndInDegrees;
+		if(S->SeqIdx != NO_SEQ) CmdSequence[S->SeqIdx].MotionNb--;
+		S->SeqIdx = NO_SEQ;
+	}
+	ServoWrite(ServoIdx, Pos);
+}
+//========================================================================================================================
+/* Eased Q15 position for a Q16 progress, from the single ease in/out table */
+static uint16_t EaseInOut(uint16_t Progress)
+{
+uint8_t  Idx = Progress >> 11;
+uint16_t Frac = Progress & 0x07FF;
+uint16_t A = PGM_READ_16(EaseInOutTbl[Idx]);
+uint16_t B = PGM_READ_16(EaseInOutTbl[Idx + 1]);
+
+	return(A + (uint16_t)(((uint32_t)(B - A) * Frac) >> 11));
+}
+//========================================================================================================================
+static uint16_t Ease(uint8_t Type, uint16_t Progress)
+{
+	switch(Type)
+	{
+		case RC_SEQ_EASE_IN_OUT:
+		return(EaseInOut(Progress));
+
+		case RC_SEQ_EASE_IN: /* First half of the curve, stretched */
+		return(EaseInOut(Progress >> 1) << 1);
+
+		case RC_SEQ_EASE_OUT: /* Second half of the curve, stretched */
+		return((EaseInOut(0x8000 + (Progress >> 1)) << 1) - EASE_ONE);
+
+		default: /* RC_SEQ_EASE_LINEAR */
+		return(Progress >> 1);
+	}
+}
+//========================================================================================================================
+static void ServoWrite(uint8_t Idx, uint16_t Angle)
+{
+	Servo[Idx].Motor.write(Angle);
+#ifdef RC_SEQ_WITH_PPM_OUT_SUPPORT
+	if(Idx < PpmOutChNb) PpmOut.write_us(Idx + 1, Servo[Idx].Motor.read_us()); /* Same angle to pulse conversion as a servo */
+#endif
+}
+#endif
+//========================================================================================================================
 #ifdef RC_SEQ_WITH_SOFT_RC_PULSE_IN_SUPPORT
+static void ProcessPulse(uint8_t ChIdx, uint16_t PulseWidthUs)
+{
+int8_t CmdPos; /* Shall be signed */
+
+	CmdPos = GetPos(ChIdx, PulseWidthUs);
+	if(CmdPos >= 0)
+	{
+		if(RcChannel[ChIdx].Pos.Idx != CmdPos)
+		{
+			  RcChannel[ChIdx].Pos.Idx = CmdPos;
+			  RcChannel[ChIdx].Pos.StartChronoMs = millis();
+		}	
+		else
+		{
+			  if((millis() - RcChannel[ChIdx].Pos.StartChronoMs) >= ((RcChannel[ChIdx].Type == RC_CMD_STICK)?STICK_PULSE_CHECK_MS:KBD_PULSE_CHECK_MS)) /* Check the Pulse is valid at least for 100 ms or 50 ms */
+			  {
+				  ExecuteSequence(ChIdx, CmdPos);
+				  RcChannel[ChIdx].Pos.Idx = NO_POS;
+			  }
+		}   
+	}
+	else
+	{
+		RcChannel[ChIdx].Pos.Idx = NO_POS;
+	}
+}
+//========================================================================================================================
 static int8_t GetPos(uint8_t ChIdx, uint16_t PulseWidthUs)
 {
 int8_t  Idx, Ret = -1;
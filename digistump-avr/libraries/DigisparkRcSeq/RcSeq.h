@@ -51,6 +51,8 @@
 #define RC_SEQ_WITH_SOFT_RC_PULSE_OUT_SUPPORT /* Uncomment this if you use <SoftRcPulseOut> library in your sketch for servos and ESC */
 #define RC_SEQ_WITH_SHORT_ACTION_SUPPORT      /* Uncomment this to allows to put call to short action in sequence table */
 #define RC_SEQ_CONTROL_SUPPORT                /* Uncomment this to allow control on sequences: start condition and end of sequence */
+//#define RC_SEQ_WITH_PPM_IN_SUPPORT          /* Uncomment this to read the RC commands from a single PPM sum signal (<SoftRcPpmIn>) */
+//#define RC_SEQ_WITH_PPM_OUT_SUPPORT         /* Uncomment this to send the servo positions as a single PPM sum signal (<SoftRcPpmOut>) */
 
 
 
@@ -58,8 +60,6 @@
 /*      /!\   Do not touch below   /!\        */
 /**********************************************/
 
-#define RC_SEQ_WITH_STATIC_MEM_ALLOC_SUPPORT   /* Do NOT comment this line for now: still buggy (to do: fix this) */
-
 #ifdef RC_SEQ_WITH_SOFT_RC_PULSE_IN_SUPPORT
 #include <TinyPinChange.h>
 #include <SoftRcPulseIn.h>
@@ -74,6 +74,16 @@
 #else
 #warning RC_SEQ_WITH_SOFT_RC_PULSE_OUT_SUPPORT disabled: no Servo/ESC command possible!!!
 #endif
+#if defined(RC_SEQ_WITH_PPM_IN_SUPPORT) && defined(RC_SEQ_WITH_SOFT_RC_PULSE_IN_SUPPORT)
+#include <SoftRcPpmIn.h>
+#else
+#undef RC_SEQ_WITH_PPM_IN_SUPPORT
+#endif
+#if defined(RC_SEQ_WITH_PPM_OUT_SUPPORT) && defined(RC_SEQ_WITH_SOFT_RC_PULSE_OUT_SUPPORT)
+#include <SoftRcPpmOut.h>
+#else
+#undef RC_SEQ_WITH_PPM_OUT_SUPPORT
+#endif
 
 #if defined(ARDUINO) && ARDUINO >= 100
 #include "Arduino.h"
@@ -113,8 +123,12 @@ typedef struct {
   uint32_t     StartMotionOffsetMs;
   uint32_t     MotionDurationMs;
   void         (*ShortAction)(void);
+  uint8_t      Ease;            /* Motion profile: RC_SEQ_EASE_LINEAR (default) to RC_SEQ_EASE_OUT */
 }SequenceSt_t;
 
+/* Motion profiles (fixed-point curve stored in flash) */
+enum {RC_SEQ_EASE_LINEAR = 0, RC_SEQ_EASE_IN_OUT, RC_SEQ_EASE_IN, RC_SEQ_EASE_OUT};
+
 typedef struct {
   uint16_t  Min;
   uint16_t  Max;
@@ -132,6 +146,10 @@ typedef struct {
 #define MOTION_WITHOUT_SOFT_START_AND_STOP(ServoIndex,StartInDegrees,EndInDegrees,StartMvtOffsetMs,MvtDurationMs)      \
   {ServoIndex, StartInDegrees, EndInDegrees, StartMvtOffsetMs, MvtDurationMs, NULL},
 
+/* Macro to declare a motion following a motion profile (to use in "Sequence[]" structure table): a single line, smoother than the soft start and soft stop above */
+#define MOTION_WITH_EASING(ServoIndex,StartInDegrees,EndInDegrees,StartMvtOffsetMs,MvtDurationMs,Ease)      \
+  {ServoIndex, StartInDegrees, EndInDegrees, StartMvtOffsetMs, MvtDurationMs, NULL, Ease},
+
 /* Macro to declare a short action (to be used in "Sequence[]" structure table) */
 #define SHORT_ACTION_TO_PERFORM(ShortAction, StartActionOffsetMs) {255, 0, 0, (StartActionOffsetMs), 0L, (ShortAction)},
 
@@ -150,6 +168,12 @@ char   *RcSeq_LibTextVersionRevision(void);
 void    RcSeq_DeclareServo(uint8_t Idx, uint8_t DigitalPin);
 void    RcSeq_ServoWrite(uint8_t Idx, uint16_t Angle);
 #endif
+#ifdef RC_SEQ_WITH_PPM_OUT_SUPPORT
+void    RcSeq_DeclarePpmOutput(uint8_t DigitalPin, uint8_t ChNb); /* Servo Idx 0 to ChNb-1 are sent as PPM channels 1 to ChNb */
+#endif
+#ifdef RC_SEQ_WITH_PPM_IN_SUPPORT
+void    RcSeq_DeclarePpmSignal(uint8_t DigitalPin, uint8_t ChNb); /* PPM channels 1 to ChNb are the RC signals Idx 0 to ChNb-1 */
+#endif
 #ifdef RC_SEQ_WITH_SOFT_RC_PULSE_IN_SUPPORT
 void    RcSeq_DeclareSignal(uint8_t Idx, uint8_t DigitalPin);
 boolean RcSeq_SignalTimeout(uint8_t Idx, uint8_t TimeoutMs, uint8_t *State);
@@ -181,6 +205,7 @@ void    RcSeq_Refresh(void);
 /* Macro en Francais de declaration mouvement   English native Macro to declare a motion */
 #define MVT_AVEC_DEBUT_ET_FIN_MVT_LENTS         MOTION_WITH_SOFT_START_AND_STOP
 #define MVT_SANS_DEBUT_ET_FIN_MVT_LENTS         MOTION_WITHOUT_SOFT_START_AND_STOP
+#define MVT_AVEC_PROFIL                         MOTION_WITH_EASING
 #define ACTION_COURTE_A_EFFECTUER               SHORT_ACTION_TO_PERFORM
 #ifdef RC_SEQ_WITH_SOFT_RC_PULSE_IN_SUPPORT
 #define RC_CLAVIER_MAISON                       RC_CUSTOM_KEYBOARD
@@ -202,5 +227,11 @@ void    RcSeq_Refresh(void);
 #define RcSeq_LanceSequence                     RcSeq_LaunchSequence
 #define RcSeq_LanceActionCourte                 RcSeq_LaunchShortAction
 #define RcSeq_Rafraichit                        RcSeq_Refresh
+#ifdef RC_SEQ_WITH_PPM_OUT_SUPPORT
+#define RcSeq_DeclareSortiePpm                  RcSeq_DeclarePpmOutput
+#endif
+#ifdef RC_SEQ_WITH_PPM_IN_SUPPORT
+#define RcSeq_DeclareSignalPpm                  RcSeq_DeclarePpmSignal
+#endif
 
 #endif
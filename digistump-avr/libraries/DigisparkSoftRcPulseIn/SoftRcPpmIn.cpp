@@ -0,0 +1,138 @@
+/*
+ English:
+ =======
+ <SoftRcPpmIn>: an asynchronous PPM (sum signal) decoder: up to 8 RC channels received on a single pin.
+ A channel is the interval between 2 rising edges, whatever the polarity of the PPM signal.
+
+ Francais:
+ ========
+ <SoftRcPpmIn>: un decodeur asynchrone de signal PPM (signal somme): jusqu'a 8 voies RC recues sur une seule broche.
+ Une voie est l'intervalle entre 2 fronts montants, quelle que soit la polarite du signal PPM.
+*/
+
+#include "SoftRcPpmIn.h"
+
+#define SOFT_RC_PPM_IN_NOT_SYNC        0xFF
+
+#ifdef MS_TIMER_TICK_EVERY_X_CYCLES
+#define MILLIS_TIMER_CYCLES_PER_TICK  MS_TIMER_TICK_EVERY_X_CYCLES
+#else
+#define MILLIS_TIMER_CYCLES_PER_TICK  64
+#endif
+
+SoftRcPpmIn *SoftRcPpmIn::first;
+#ifdef SOFT_RC_PULSE_IN_ICP_SUPPORT
+SoftRcPpmIn *SoftRcPpmIn::IcpPpmIn;
+#endif
+
+SoftRcPpmIn::SoftRcPpmIn(void)
+{
+}
+
+void SoftRcPpmIn::Init(uint8_t Pin, uint8_t ChNb, uint8_t CyclesPerTick)
+{
+	_Pin = Pin;
+	_ChMax = (ChNb > SOFT_RC_PPM_IN_CH_MAX) ? SOFT_RC_PPM_IN_CH_MAX : ChNb;
+	_ChIdx = SOFT_RC_PPM_IN_NOT_SYNC;
+	_ChNb = 0;
+	_Available = 0;
+	_CyclesPerTick = CyclesPerTick;
+	_SyncTicks = SoftRcPulseIn::UsToTicks(SOFT_RC_PPM_IN_SYNC_MIN_US, CyclesPerTick);
+	pinMode(_Pin,INPUT);
+	digitalWrite(_Pin, HIGH);
+}
+
+uint8_t SoftRcPpmIn::attach(uint8_t Pin, uint8_t ChNb/*=SOFT_RC_PPM_IN_CH_MAX*/)
+{
+uint8_t Ret=0;
+int8_t  VirtualPortIdx;
+
+	Init(Pin, ChNb, MILLIS_TIMER_CYCLES_PER_TICK);
+	_PinMask = TinyPinChange_PinToMsk(Pin);
+	VirtualPortIdx = TinyPinChange_RegisterIsr(_Pin, SoftRcPpmIn::SoftRcPpmInInterrupt);
+	if(VirtualPortIdx >= 0)
+	{
+	  _VirtualPortIdx = VirtualPortIdx;
+	  next = first;
+	  first = this;
+	  TinyPinChange_EnablePin(_Pin);
+	  Ret=1;
+	}
+	return(Ret);
+}
+
+#ifdef SOFT_RC_PULSE_IN_ICP_SUPPORT
+uint8_t SoftRcPpmIn::attachIcp(uint8_t Pin, uint8_t ChNb/*=SOFT_RC_PPM_IN_CH_MAX*/)
+{
+	Init(Pin, ChNb, SOFT_RC_PULSE_IN_ICP_CYCLES_PER_TICK);
+	_PinMask = 0;
+	IcpPpmIn = this;
+	SoftRcPulseIn::IcpAttach(SoftRcPpmIn::IcpEdge, 0); /* Rising edges only */
+	return(1);
+}
+
+void SoftRcPpmIn::IcpEdge(uint16_t Ticks, uint8_t Rising)
+{
+	IcpPpmIn->Edge(Ticks);
+}
+#endif
+
+boolean SoftRcPpmIn::available(void)
+{
+boolean Ret = _Available;
+
+	_Available = 0;
+	return(Ret);
+}
+
+uint8_t SoftRcPpmIn::channels(void)
+{
+	return(_ChNb);
+}
+
+uint16_t SoftRcPpmIn::width_us(uint8_t Ch)
+{
+uint16_t Width;
+
+	if(!Ch || Ch > _ChMax) return(0);
+	noInterrupts();
+	Width = _Width[Ch - 1];
+	interrupts();
+	return(SoftRcPulseIn::TicksToUs(Width, _CyclesPerTick)); /* Converted here rather than in the ISR */
+}
+
+void SoftRcPpmIn::Edge(uint16_t Ticks)
+{
+uint16_t Interval = Ticks - _Last;
+
+	_Last = Ticks;
+	if(Interval >= _SyncTicks)
+	{
+		/* Synchro: the frame just received is complete */
+		if((_ChIdx != SOFT_RC_PPM_IN_NOT_SYNC) && _ChIdx)
+		{
+			_ChNb = _ChIdx;
+			_Available = 1;
+		}
+		_ChIdx = 0;
+	}
+	else if(_ChIdx < _ChMax)
+	{
+		_Width[_ChIdx++] = Interval;
+	}
+	/* else: not synchronized yet, or extra channels */
+}
+
+void SoftRcPpmIn::SoftRcPpmInInterrupt(void)
+{
+SoftRcPpmIn *PpmIn;
+uint16_t     Now = SoftRcPulseIn::Ticks(); /* Taken once, as early as possible */
+
+  for ( PpmIn = first; PpmIn != 0; PpmIn = PpmIn->next )
+  {
+    if(TinyPinChange_GetPortEvent(PpmIn->_VirtualPortIdx)&PpmIn->_PinMask&TinyPinChange_GetCurPortSt(PpmIn->_VirtualPortIdx))
+    {
+	  PpmIn->Edge(Now); /* Rising edge */
+    }
+  }
+}
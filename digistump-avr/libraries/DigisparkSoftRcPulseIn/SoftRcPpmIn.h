@@ -0,0 +1,58 @@
+/*
+ English:
+ =======
+ <SoftRcPpmIn>: an asynchronous PPM (sum signal) decoder: up to 8 RC channels received on a single pin.
+ It relies on the same time stamps as <SoftRcPulseIn> by RC Navy (raw timer count, or Timer1 input capture).
+
+ Francais:
+ ========
+ <SoftRcPpmIn>: un decodeur asynchrone de signal PPM (signal somme): jusqu'a 8 voies RC recues sur une seule broche.
+ Il s'appuie sur les memes horodatages que <SoftRcPulseIn> par RC Navy (compteur brut du timer, ou capture d'entree du Timer1).
+*/
+
+#ifndef SOFT_RC_PPM_IN_H
+#define SOFT_RC_PPM_IN_H
+
+#include "SoftRcPulseIn.h"
+
+#define SOFT_RC_PPM_IN_CH_MAX          8
+#define SOFT_RC_PPM_IN_SYNC_MIN_US     3000 /* A longer interval between 2 rising edges is the frame synchro */
+
+class SoftRcPpmIn
+{
+  public:
+    SoftRcPpmIn();
+    static void  SoftRcPpmInInterrupt(void);
+    uint8_t      attach(uint8_t Pin, uint8_t ChNb = SOFT_RC_PPM_IN_CH_MAX);
+#ifdef SOFT_RC_PULSE_IN_ICP_SUPPORT
+    uint8_t      attachIcp(uint8_t Pin, uint8_t ChNb = SOFT_RC_PPM_IN_CH_MAX); /* Pin shall be the ICP1 pin */
+#endif
+    boolean      available();                /* A new complete frame was received */
+    uint8_t      channels();                 /* Number of channels of the last frame */
+    uint16_t     width_us(uint8_t Ch);       /* Ch from 1 to channels() */
+    private:
+    class SoftRcPpmIn  *next;
+    static SoftRcPpmIn *first;
+	uint8_t _Pin;
+	uint8_t _PinMask;
+	uint8_t _VirtualPortIdx;
+	uint8_t _CyclesPerTick;
+	uint8_t _ChMax;
+	uint8_t _ChIdx;      /* Channel being received, SOFT_RC_PPM_IN_NOT_SYNC until the first synchro */
+	volatile uint8_t _ChNb;
+	volatile boolean _Available;
+	uint16_t _SyncTicks;
+	uint16_t _Last;      /* Time stamp of the last rising edge, in ticks */
+	uint16_t _Width[SOFT_RC_PPM_IN_CH_MAX];
+	void Edge(uint16_t Ticks);
+	void Init(uint8_t Pin, uint8_t ChNb, uint8_t CyclesPerTick);
+#ifdef SOFT_RC_PULSE_IN_ICP_SUPPORT
+	static SoftRcPpmIn *IcpPpmIn;
+	static void IcpEdge(uint16_t Ticks, uint8_t Rising);
+#endif
+};
+
+/*      Methodes en Francais                            English native methods */
+#define voies											channels
+
+#endif
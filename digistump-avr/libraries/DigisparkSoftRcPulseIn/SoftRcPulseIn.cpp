@@ -5,24 +5,53 @@
  http://p.loussouarn.free.fr
  V1.0: initial release
  V1.1: asynchronous timeout support added (up to 250ms)
+ V1.2: edges time stamped with the raw timer count (no more micros() in the ISR), width converted in width_us(), Timer1 input capture support
  Francais: par RC Navy (2012-2015)
  ========
  <SoftRcPulseIn>: une librairie asynchrone pour lire les largeur d'impulsions des Radio-Commandes standards. Cette librairie est une version non bloquante de pulsIn().
  http://p.loussouarn.free.fr
  V1.0: release initiale
  V1.1: support de timeout asynchrone ajoutee (jusqu'a 250ms)
+ V1.2: fronts dates avec le compteur brut du timer (plus de micros() dans l'ISR), largeur convertie dans width_us(), support de la capture d'entree du Timer1
 */
 
 #include "SoftRcPulseIn.h"
 
 #define LIB_VERSION                    1
-#define LIB_REVISION                   1
+#define LIB_REVISION                   2
 
 #define STR(s)						#s
 #define MAKE_TEXT_VER_REV(Ver,Rev)	STR(Ver)"."STR(Rev)
 
 #define LIB_TEXT_VERSION_REVISION	MAKE_TEXT_VER_REV(LIB_VERSION,LIB_REVISION) /* Make Full version as a string "Ver.Rev" */
 
+/* Raw time stamp: low byte from the counter of the millis() timer, high byte from its overflow count */
+#ifndef TIMER_TO_USE_FOR_MILLIS //This symbol is not defined arduino standard core and is defined in core_build_options.h in DigiStump version
+#define MILLIS_TIMER_OVF_CNT     timer0_overflow_count //For arduino standard core of UNO/MEGA, etc
+#define MILLIS_TIMER_TCNT        TCNT0
+#define MILLIS_TIMER_TIFR        TIFR0
+#define MILLIS_TIMER_TOV         TOV0
+#else
+#define MILLIS_TIMER_OVF_CNT     millis_timer_overflow_count
+#if (TIMER_TO_USE_FOR_MILLIS==1)
+#define MILLIS_TIMER_TCNT        TCNT1 //For example for ATtiny85
+#define MILLIS_TIMER_TIFR        TIFR
+#define MILLIS_TIMER_TOV         TOV1
+#else
+#define MILLIS_TIMER_TCNT        TCNT0 //For example for ATtiny84 and ATtiny167
+#define MILLIS_TIMER_TIFR        TIFR0
+#define MILLIS_TIMER_TOV         TOV0
+#endif
+#endif
+
+#ifdef MS_TIMER_TICK_EVERY_X_CYCLES
+#define MILLIS_TIMER_CYCLES_PER_TICK  MS_TIMER_TICK_EVERY_X_CYCLES
+#else
+#define MILLIS_TIMER_CYCLES_PER_TICK  64
+#endif
+
+extern "C" volatile unsigned long MILLIS_TIMER_OVF_CNT;
+
 SoftRcPulseIn *SoftRcPulseIn::first;
 
 SoftRcPulseIn::SoftRcPulseIn(void)
@@ -35,8 +64,9 @@ uint8_t Ret=0;
 
 	_Pin=Pin;
 	_PinMask = TinyPinChange_PinToMsk(Pin);
-	_Min_us = PulseMin_us;
-	_Max_us = PulseMax_us;
+	_CyclesPerTick = MILLIS_TIMER_CYCLES_PER_TICK;
+	_MinTicks = UsToTicks(PulseMin_us, _CyclesPerTick);
+	_MaxTicks = UsToTicks(PulseMax_us, _CyclesPerTick);
 	next = first;
 	first = this;
 	pinMode(_Pin,INPUT);
@@ -50,6 +80,25 @@ uint8_t Ret=0;
 	return(Ret);
 }
 
+uint16_t SoftRcPulseIn::Ticks(void)
+{
+uint8_t Hi = (uint8_t)MILLIS_TIMER_OVF_CNT;
+uint8_t Lo = MILLIS_TIMER_TCNT;
+
+	if((MILLIS_TIMER_TIFR & _BV(MILLIS_TIMER_TOV)) && (Lo < 255)) Hi++; /* Overflow not yet counted */
+	return(((uint16_t)Hi << 8) | Lo);
+}
+
+uint16_t SoftRcPulseIn::TicksToUs(uint16_t Ticks, uint8_t CyclesPerTick)
+{
+	return(((uint32_t)Ticks * CyclesPerTick * 1000UL) / (F_CPU / 1000UL));
+}
+
+uint16_t SoftRcPulseIn::UsToTicks(uint16_t Us, uint8_t CyclesPerTick)
+{
+	return(((uint32_t)Us * (F_CPU / 1000UL)) / (1000UL * CyclesPerTick));
+}
+
 int SoftRcPulseIn::LibVersion(void)
 {
   return(LIB_VERSION);
@@ -68,14 +117,14 @@ char *SoftRcPulseIn::LibTextVersionRevision(void)
 uint8_t SoftRcPulseIn::available(void)
 {
 boolean Ret=0;
-uint16_t PulseWidth_us;
+uint16_t PulseWidth;
 
   if(_Available)
   {
 	noInterrupts();
-	PulseWidth_us = _Width_us;
+	PulseWidth = _Width;
 	interrupts();
-	Ret=_Available && (PulseWidth_us >= _Min_us) && (PulseWidth_us <= _Max_us);
+	Ret=_Available && (PulseWidth >= _MinTicks) && (PulseWidth <= _MaxTicks);
 	_Available=0;
   }
   return(Ret);
@@ -96,35 +145,41 @@ boolean SoftRcPulseIn::timeout(uint8_t TimeoutMs, uint8_t *CurrentState)
 #endif
 uint16_t SoftRcPulseIn::width_us(void)
 {
-uint16_t PulseWidth_us;
+uint16_t PulseWidth;
   noInterrupts();
-  PulseWidth_us = _Width_us;
+  PulseWidth = _Width;
   interrupts();
-  return(PulseWidth_us);  
+  return(TicksToUs(PulseWidth, _CyclesPerTick)); /* Converted here rather than in the ISR */
+}
+
+void SoftRcPulseIn::Edge(uint16_t Ticks, uint8_t Rising)
+{
+  if(Rising)
+  {
+	  /* High level, rising edge: start chrono */
+	  _Start = Ticks;
+  }
+  else
+  {
+	  /* Low level, falling edge: stop chrono */
+	  _Width = Ticks - _Start;
+	  _Available = 1;
+#ifdef SOFT_RC_PULSE_IN_TIMEOUT_SUPPORT
+	  _LastTimeStampMs = (uint8_t)(millis() & 0x000000FF);
+#endif
+  }
 }
 
 void SoftRcPulseIn::SoftRcPulseInInterrupt(void)
 {
 SoftRcPulseIn *RcPulseIn;
+uint16_t       Now = Ticks(); /* Taken once, as early as possible */
 
   for ( RcPulseIn = first; RcPulseIn != 0; RcPulseIn = RcPulseIn->next )
   {
     if(TinyPinChange_GetPortEvent(RcPulseIn->_VirtualPortIdx)&RcPulseIn->_PinMask)
     {
-	  if(digitalRead(RcPulseIn->_Pin))
-	  {
-		  /* High level, rising edge: start chrono */
-		  RcPulseIn->_Start_us = micros();
-	  }
-	  else
-	  {
-		  /* Low level, falling edge: stop chrono */
-		  RcPulseIn->_Width_us = micros() - RcPulseIn->_Start_us;
-		  RcPulseIn->_Available = 1;
-#ifdef SOFT_RC_PULSE_IN_TIMEOUT_SUPPORT
-		  RcPulseIn->_LastTimeStampMs = (uint8_t)(millis() & 0x000000FF);
-#endif
-	  }
+	  RcPulseIn->Edge(Now, TinyPinChange_GetCurPortSt(RcPulseIn->_VirtualPortIdx)&RcPulseIn->_PinMask);
     }
   }
 }
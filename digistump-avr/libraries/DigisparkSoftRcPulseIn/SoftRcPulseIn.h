@@ -25,6 +25,12 @@
 
 #define SOFT_RC_PULSE_IN_TIMEOUT_SUPPORT
 
+/* Timer1 input capture (ICP1 pin): ATtiny167, ATtiny84, UNO, MEGA (not ATtiny85) */
+#if defined(ICR1) && defined(TIMER1_CAPT_vect)
+#define SOFT_RC_PULSE_IN_ICP_SUPPORT
+#define SOFT_RC_PULSE_IN_ICP_CYCLES_PER_TICK   8 /* Timer1 prescaler: 0.5us resolution at 16MHz */
+#endif
+
 class SoftRcPulseIn
 {
   public:
@@ -34,22 +40,38 @@ class SoftRcPulseIn
     static char *LibTextVersionRevision(void);
     static void  SoftRcPulseInInterrupt(void);
     uint8_t      attach(uint8_t Pin, uint16_t PulseMin_us = 600, uint16_t PulseMax_us = 2400);
+#ifdef SOFT_RC_PULSE_IN_ICP_SUPPORT
+    uint8_t      attachIcp(uint8_t Pin, uint16_t PulseMin_us = 600, uint16_t PulseMax_us = 2400); /* Pin shall be the ICP1 pin */
+#endif
     boolean      available();
     boolean      timeout(uint8_t TimeoutMs, uint8_t *State);
     uint16_t     width_us();
+    /* Shared with SoftRcPpmIn */
+    static uint16_t Ticks(void);  /* Raw 16 bit time stamp of the millis() timer, to call with interrupts masked */
+    static uint16_t TicksToUs(uint16_t Ticks, uint8_t CyclesPerTick);
+    static uint16_t UsToTicks(uint16_t Us, uint8_t CyclesPerTick);
+#ifdef SOFT_RC_PULSE_IN_ICP_SUPPORT
+    static void     IcpAttach(void (*Handler)(uint16_t Ticks, uint8_t Rising), boolean BothEdges);
+#endif
     private:
     class SoftRcPulseIn  *next;
     static SoftRcPulseIn *first;
 	uint8_t _Pin;
 	uint8_t _PinMask;
 	uint8_t _VirtualPortIdx;
-	uint16_t _Min_us;
-	uint16_t _Max_us;
-	uint32_t _Start_us;
-	uint32_t _Width_us;
-	boolean  _Available;
+	uint8_t _CyclesPerTick;
+	uint16_t _MinTicks;
+	uint16_t _MaxTicks;
+	uint16_t _Start;     /* Time stamp of the rising edge, in ticks */
+	volatile uint16_t _Width; /* Pulse width in ticks, converted to us only when read */
+	volatile boolean  _Available;
 #ifdef SOFT_RC_PULSE_IN_TIMEOUT_SUPPORT
 	uint8_t _LastTimeStampMs;
+#endif
+	void Edge(uint16_t Ticks, uint8_t Rising);
+#ifdef SOFT_RC_PULSE_IN_ICP_SUPPORT
+	static SoftRcPulseIn *IcpPulseIn;
+	static void IcpEdge(uint16_t Ticks, uint8_t Rising);
 #endif
 };
 /*******************************************************/
@@ -0,0 +1,64 @@
+/*
+ <SoftRcPulseIn> Timer1 input capture, see SoftRcPulseIn.h.
+ Kept apart from SoftRcPulseIn.cpp so that the TIMER1_CAPT vector is only linked into the sketches
+ calling attachIcp() or IcpAttach(): the others keep Timer1 (tone(), PWM) for themselves.
+*/
+
+#include "SoftRcPulseIn.h"
+
+#ifdef SOFT_RC_PULSE_IN_ICP_SUPPORT
+SoftRcPulseIn *SoftRcPulseIn::IcpPulseIn;
+static void  (*IcpHandler)(uint16_t Ticks, uint8_t Rising);
+static boolean IcpBothEdges;
+
+uint8_t SoftRcPulseIn::attachIcp(uint8_t Pin, uint16_t PulseMin_us/*=600*/, uint16_t PulseMax_us/*=2400*/)
+{
+	_Pin=Pin;
+	_PinMask = 0;
+	_CyclesPerTick = SOFT_RC_PULSE_IN_ICP_CYCLES_PER_TICK;
+	_MinTicks = UsToTicks(PulseMin_us, _CyclesPerTick);
+	_MaxTicks = UsToTicks(PulseMax_us, _CyclesPerTick);
+	pinMode(_Pin,INPUT);
+	digitalWrite(_Pin, HIGH);
+	IcpPulseIn = this;
+	IcpAttach(SoftRcPulseIn::IcpEdge, 1);
+	return(1);
+}
+
+void SoftRcPulseIn::IcpEdge(uint16_t Ticks, uint8_t Rising)
+{
+	IcpPulseIn->Edge(Ticks, Rising);
+}
+
+/*
+ Timer1 is taken over: normal mode, clk/8, noise canceler. Its PWM pins and tone() are no longer usable.
+ The edges are time stamped by the hardware, so the ISR latency does not matter.
+*/
+void SoftRcPulseIn::IcpAttach(void (*Handler)(uint16_t Ticks, uint8_t Rising), boolean BothEdges)
+{
+	noInterrupts();
+	IcpHandler = Handler;
+	IcpBothEdges = BothEdges;
+	TCCR1A = 0;
+#ifdef TCCR1D
+	TCCR1D = 0; /* ATtiny167: OC1x pins disconnected */
+#endif
+	TCCR1B = _BV(ICNC1) | _BV(ICES1) | _BV(CS11); /* Rising edge first */
+	TIFR1 = _BV(ICF1);
+	TIMSK1 = _BV(ICIE1);
+	interrupts();
+}
+
+ISR(TIMER1_CAPT_vect)
+{
+uint16_t Ticks = ICR1;
+uint8_t  Rising = TCCR1B & _BV(ICES1);
+
+	if(IcpBothEdges)
+	{
+		TCCR1B ^= _BV(ICES1); /* Wait for the other edge */
+		TIFR1 = _BV(ICF1);    /* Changing the edge may set the flag */
+	}
+	IcpHandler(Ticks, Rising);
+}
+#endif
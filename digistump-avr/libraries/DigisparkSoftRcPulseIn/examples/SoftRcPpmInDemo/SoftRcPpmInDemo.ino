@@ -0,0 +1,35 @@
+/*
+   PPM sum signal decoding: the 8 channels of a receiver PPM output on a single pin.
+   On ATtiny167 (Digispark pro), UNO or MEGA, use attachIcp() on the ICP1 pin (PA4 = D11 on the Digispark pro)
+   for a 0.5us resolution: Timer1 is then used by the library.
+*/
+#include <SoftRcPpmIn.h>
+#include <TinyPinChange.h>
+
+#define PPM_PIN  2
+
+SoftRcPpmIn Ppm;
+
+
+void setup()
+{
+#if !defined(__AVR_ATtiny24__) && !defined(__AVR_ATtiny44__) && !defined(__AVR_ATtiny84__) && !defined(__AVR_ATtiny25__) && !defined(__AVR_ATtiny45__) && !defined(__AVR_ATtiny85__)
+    Serial.begin(9600);
+    Serial.print("SoftRcPulseIn library V");Serial.print(SoftRcPulseIn::LibTextVersionRevision());Serial.println(" PPM demo");
+#endif
+  Ppm.attach(PPM_PIN);
+}
+
+void loop()
+{
+  if(Ppm.available())
+  {
+#if !defined(__AVR_ATtiny24__) && !defined(__AVR_ATtiny44__) && !defined(__AVR_ATtiny84__) && !defined(__AVR_ATtiny25__) && !defined(__AVR_ATtiny45__) && !defined(__AVR_ATtiny85__)
+    for(uint8_t Ch = 1; Ch <= Ppm.channels(); Ch++)
+    {
+      Serial.print(Ppm.width_us(Ch));Serial.print(' ');
+    }
+    Serial.println();
+#endif
+  }
+}
@@ -0,0 +1,115 @@
+#include "SoftRcPpmOut.h"
+/*
+ English:
+ =======
+ <SoftRcPpmOut>: PPM sum signal generation on the compare interrupt shared with <SoftRcPulseOut> (by RC Navy).
+ The ISR calls SoftRcPpmOut::event() at each edge: the next edge is programmed from the returned ticks.
+
+ Francais:
+ ========
+ <SoftRcPpmOut>: generation d'un signal PPM somme sur l'interruption de comparaison partagee avec <SoftRcPulseOut> (par RC Navy).
+ L'ISR appelle SoftRcPpmOut::event() a chaque front: le front suivant est programme a partir des ticks retournes.
+*/
+
+#define NO_EVENT 0xFFFF
+
+/* Constant durations, in ticks: nothing to compute in the ISR */
+#define PPM_SEP_TICKS       SOFT_RC_PULSE_OUT_US_TO_TICKS(SOFT_RC_PPM_OUT_SEP_US)
+#define PPM_FRAME_TICKS     SOFT_RC_PULSE_OUT_US_TO_TICKS(SOFT_RC_PPM_OUT_FRAME_US)
+#define PPM_SYNC_MIN_TICKS  SOFT_RC_PULSE_OUT_US_TO_TICKS(SOFT_RC_PPM_OUT_SYNC_MIN_US)
+
+SoftRcPpmOut *SoftRcPpmOut::active;
+
+SoftRcPpmOut::SoftRcPpmOut() : port(0), mask(0), inverted(0), chNb(0)
+{}
+
+void SoftRcPpmOut::level(uint8_t pulse)
+{
+    if ( pulse ^ inverted ) *port |= mask;
+    else                    *port &= ~mask;
+}
+
+uint8_t SoftRcPpmOut::attach(uint8_t pin, uint8_t chNbArg, bool invertedArg)
+{
+    if ( !chNbArg || chNbArg > SOFT_RC_PPM_OUT_CH_MAX ) return (0);
+    detach();
+    port     = portOutputRegister(digitalPinToPort(pin));
+    mask     = digitalPinToBitMask(pin);
+    inverted = invertedArg;
+    chNb     = chNbArg;
+    idx      = chNb + 1; /* The first slot starts a frame */
+    sep      = 0;
+    for ( uint8_t i = 0; i < chNb; i++ ) width[i] = SOFT_RC_PULSE_OUT_US_TO_TICKS(1500);
+    digitalWrite(pin, inverted ? HIGH : LOW);
+    pinMode(pin, OUTPUT);
+    active = this;
+    SoftRcPulseOut::hook(SoftRcPpmOut::event);
+    return (1);
+}
+
+void SoftRcPpmOut::detach()
+{
+    if ( active != this ) return;
+    SoftRcPulseOut::hook(0);
+    active = 0;
+    level(0);
+}
+
+void SoftRcPpmOut::write_us(uint8_t ch, uint16_t width_us)
+{
+    uint16_t ticks;
+
+    if ( !ch || ch > chNb ) return;
+    if ( width_us < 2 * SOFT_RC_PPM_OUT_SEP_US ) width_us = 2 * SOFT_RC_PPM_OUT_SEP_US;
+    if ( width_us > 2500 ) width_us = 2500;
+    ticks = SoftRcPulseOut::usToTicks(width_us);
+    noInterrupts();
+    width[ch - 1] = ticks;
+    interrupts();
+}
+
+uint16_t SoftRcPpmOut::read_us(uint8_t ch)
+{
+    uint16_t ticks;
+
+    if ( !ch || ch > chNb ) return (0);
+    noInterrupts();
+    ticks = width[ch - 1];
+    interrupts();
+    return (SoftRcPulseOut::ticksToUs(ticks));
+}
+
+/* Called from the compare ISR at each edge: returns the ticks to the next edge */
+uint16_t SoftRcPpmOut::event(void)
+{
+    SoftRcPpmOut *p = active;
+
+    if ( !p ) return (NO_EVENT);
+    if ( p->sep )
+    {
+        /* End of the separator pulse: idle until the end of the slot */
+        p->level(0);
+        p->sep = 0;
+        return (p->slot - PPM_SEP_TICKS);
+    }
+    /* Start of a slot */
+    if ( p->idx > p->chNb )
+    {
+        p->idx     = 0;
+        p->elapsed = 0;
+    }
+    if ( p->idx < p->chNb )
+    {
+        p->slot = p->width[p->idx];
+    }
+    else
+    {
+        /* Synchro: completes the frame */
+        p->slot = (p->elapsed + PPM_SYNC_MIN_TICKS < PPM_FRAME_TICKS) ? (PPM_FRAME_TICKS - p->elapsed) : PPM_SYNC_MIN_TICKS;
+    }
+    p->elapsed += p->slot;
+    p->idx++;
+    p->level(1);
+    p->sep = 1;
+    return (PPM_SEP_TICKS);
+}
@@ -0,0 +1,54 @@
+#ifndef SoftRcPpmOut_h
+#define SoftRcPpmOut_h
+
+/*
+ English:
+ =======
+ <SoftRcPpmOut>: generates a PPM sum signal (up to 8 RC channels on a single pin), for example for a trainer port or a
+ receiver expecting a PPM input. It shares the compare interrupt of <SoftRcPulseOut>: servos and PPM can be used together.
+ Each channel starts with a 300us separator pulse, a frame lasts 22.5ms.
+
+ Francais:
+ ========
+ <SoftRcPpmOut>: genere un signal PPM somme (jusqu'a 8 voies RC sur une seule broche), par exemple pour une prise ecolage
+ ou un recepteur attendant une entree PPM. Elle partage l'interruption de comparaison de <SoftRcPulseOut>: servos et PPM
+ peuvent etre utilises ensemble. Chaque voie commence par une impulsion de separation de 300us, une trame dure 22.5ms.
+*/
+
+#include "SoftRcPulseOut.h"
+
+#define SOFT_RC_PPM_OUT_CH_MAX        8
+#define SOFT_RC_PPM_OUT_FRAME_US      22500
+#define SOFT_RC_PPM_OUT_SEP_US        300
+#define SOFT_RC_PPM_OUT_SYNC_MIN_US   4000
+
+class SoftRcPpmOut
+{
+  private:
+    volatile uint8_t *port;
+    uint8_t        mask;
+    uint8_t        inverted;   // separator pulses low, idle level high
+    uint8_t        chNb;
+    uint8_t        idx;        // slot in progress, chNb is the synchro slot
+    uint8_t        sep;        // 1 during the separator pulse
+    uint16_t       slot;       // length of the slot in progress, in ticks
+    uint16_t       elapsed;    // ticks since the start of the frame
+    uint16_t       width[SOFT_RC_PPM_OUT_CH_MAX]; // in ticks
+    static         SoftRcPpmOut *active;
+    static uint16_t event(void);
+    void           level(uint8_t pulse);
+  public:
+    SoftRcPpmOut();
+    uint8_t        attach(uint8_t pin, uint8_t chNb = SOFT_RC_PPM_OUT_CH_MAX, bool inverted = false); // only one SoftRcPpmOut at a time
+    void           detach();
+    void           write_us(uint8_t ch, uint16_t width_us); // ch from 1 to chNb, 1500us by default
+    uint16_t       read_us(uint8_t ch);
+};
+
+/*      Methodes en Francais                    English native methods */
+#define attache                                       attach
+#define detache                                       detach
+#define ecrit_us                                      write_us
+#define lit_us                                        read_us
+
+#endif
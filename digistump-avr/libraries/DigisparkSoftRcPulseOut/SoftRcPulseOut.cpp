@@ -2,14 +2,16 @@
 /*
  Update 01/03/2013: add support for Digispark (http://digistump.com): automatic Timer selection (RC Navy: p.loussouarn.free.fr)
  Update 19/08/2014: usage with write_us and read_us fixed
+ Update 19/10/2026: pulses generated by a compare match ISR of the millis() timer: refresh() no longer blocks
 
  English: by RC Navy (2012)
  =======
  <SoftRcPulseOut>: a library mainly based on the <SoftwareServo> library, but with a better pulse generation to limit jitter.
  It supports the same methods as <SoftwareServo>.
  It also support Pulse Width order given in microseconds. The current Pulse Width can also be read in microseconds.
- The refresh method can admit an optionnal argument (force). If SoftRcPulseOut::refresh(1) is called, the refresh is forced even if 20 ms are not elapsed.
- The refresh() method returns 1 if refresh done (can be used for synchro and/or for 20ms timer).
+ The pulses are generated every 20 ms by a compare match interrupt of the millis() timer: calling refresh() is no longer required.
+ The refresh method can admit an optionnal argument (force). If SoftRcPulseOut::refresh(1) is called, the next frame starts at once even if 20 ms are not elapsed.
+ The refresh() method returns 1 once per frame (can be used for synchro and/or for 20ms timer).
  http://p.loussouarn.free.fr
 
  Francais: par RC Navy (2012)
@@ -17,22 +19,83 @@
  <SoftRcPulseOut>: une librairie majoritairement basee sur la librairie <SoftwareServo>, mais avec une meilleure generation des impulsions pour limiter la gigue.
  Elle supporte les memes methodes que <SoftwareServo>.
  Elle supporte egalement une consigne de largeur d'impulsion passee en microseconde. La largeur de l'impulsion courante peut egalement etre lue en microseconde.
- La methode refresh peut admettre un parametre optionnel (force). Si SoftRcPulseOut::resfresh(1) est appelee, le refresh est force meme si 20 ms ne se sont pas ecoulee.
- La methode refresh() retourne 1 si refresh effectue (peut etre utilise pour synhro et/ou 20ms timer).
+ Les impulsions sont generees toutes les 20 ms par une interruption de comparaison du timer de millis(): appeler refresh() n'est plus necessaire.
+ La methode refresh peut admettre un parametre optionnel (force). Si SoftRcPulseOut::resfresh(1) est appelee, la trame suivante demarre aussitot meme si 20 ms ne se sont pas ecoulee.
+ La methode refresh() retourne 1 une fois par trame (peut etre utilise pour synhro et/ou 20ms timer).
  http://p.loussouarn.free.fr
 */
 
 /* Automatic Timer selection (at compilation time) */
+/* The pulses are timed with a compare unit of the millis() timer which is left running untouched */
 #ifndef TIMER_TO_USE_FOR_MILLIS //This symbol is not defined arduino standard core and is defined in core_build_options.h in DigiStump version
-#define SOFT_RC_PULSE_OUT_TCNT TCNT0 //For arduino standard core of UNO/MEGA, etc
+#define SOFT_RC_PULSE_OUT_TCNT  TCNT0 //For arduino standard core of UNO/MEGA, etc
+#define SOFT_RC_PULSE_OUT_OCR   OCR0A
+#define SOFT_RC_PULSE_OUT_TIMSK TIMSK0
+#define SOFT_RC_PULSE_OUT_OCIE  OCIE0A
+#define SOFT_RC_PULSE_OUT_TIFR  TIFR0
+#define SOFT_RC_PULSE_OUT_OCF   OCF0A
+#define SOFT_RC_PULSE_OUT_vect  TIMER0_COMPA_vect
 #else
 #if (TIMER_TO_USE_FOR_MILLIS==1)
-#define SOFT_RC_PULSE_OUT_TCNT TCNT1 //For example for ATtiny85
+#define SOFT_RC_PULSE_OUT_TCNT  TCNT1 //For example for ATtiny85 (OCR1A is not used for PWM)
+#define SOFT_RC_PULSE_OUT_OCR   OCR1A
+#define SOFT_RC_PULSE_OUT_TIMSK TIMSK
+#define SOFT_RC_PULSE_OUT_OCIE  OCIE1A
+#define SOFT_RC_PULSE_OUT_TIFR  TIFR
+#define SOFT_RC_PULSE_OUT_OCF   OCF1A
+#define SOFT_RC_PULSE_OUT_vect  TIMER1_COMPA_vect
 #else
-#define SOFT_RC_PULSE_OUT_TCNT TCNT0 //For example for ATtiny84 and ATtiny167
+#define SOFT_RC_PULSE_OUT_TCNT  TCNT0 //For example for ATtiny84 and ATtiny167
+#define SOFT_RC_PULSE_OUT_OCR   OCR0A
+#define SOFT_RC_PULSE_OUT_TIMSK TIMSK0
+#define SOFT_RC_PULSE_OUT_OCIE  OCIE0A
+#define SOFT_RC_PULSE_OUT_TIFR  TIFR0
+#define SOFT_RC_PULSE_OUT_OCF   OCF0A
+#define SOFT_RC_PULSE_OUT_vect  TIMER0_COMPA_vect
 #endif
 #endif
 
+#define FRAME_TICKS             (uint16_t)((F_CPU / 1000L) * 20L / SOFT_RC_PULSE_OUT_TICK) /* 20ms */
+#define MAX_STEP_TICKS          200 /* Longest compare step: the timer is 8 bit */
+#define NO_EVENT                0xFFFF
+
+#ifndef SOFT_RC_PULSE_OUT_PORTS
+#define SOFT_RC_PULSE_OUT_PORTS 3   /* Maximum number of different ports used by the servos */
+#endif
+
+enum {SRV_IDLE = 0, SRV_GAP, SRV_PULSE};
+
+typedef struct {
+  uint16_t          at;      /* Falling edge, in ticks from the start of the frame */
+  volatile uint8_t *port;
+  uint8_t           mask;    /* Pins of 'port' falling at this edge */
+} EdgeSt_t;
+
+typedef struct {
+  volatile uint8_t *port;
+  uint8_t           mask;    /* Pins of 'port' rising at the start of the frame */
+} RaiseSt_t;
+
+typedef struct {
+  uint8_t           edges;
+  uint8_t           ports;
+  EdgeSt_t          edge[SOFT_RC_PULSE_OUT_MAX];
+  RaiseSt_t         raise[SOFT_RC_PULSE_OUT_PORTS];
+} ScheduleSt_t;
+
+/* Double buffered: the ISR plays sched[active], schedule() fills the other one and the ISR swaps them at the next frame start */
+static ScheduleSt_t     sched[2];
+static uint8_t          active;
+static volatile uint8_t pending;
+static volatile uint8_t state;
+static volatile uint8_t frames;
+static uint8_t          idx;     /* Next edge of the frame */
+
+/* Two timelines share the compare unit: the servos and an optional hooked pulse train (e.g. SoftRcPpmOut) */
+static uint16_t         srvWait = NO_EVENT;  /* Ticks still to wait before the next servo event */
+static uint16_t         hookWait = NO_EVENT; /* Ticks still to wait before the next hook event */
+static uint16_t       (*hookEvent)(void);
+
 SoftRcPulseOut *SoftRcPulseOut::first;
 
 #define NO_ANGLE (0xff)
@@ -52,6 +115,11 @@ void SoftRcPulseOut::setMaximumPulse(uint16_t t)
 
 uint8_t SoftRcPulseOut::attach(int pinArg)
 {
+    uint8_t Nb = 0;
+
+    detach(); /* Never twice in the list */
+    for ( SoftRcPulseOut *p = first; p != 0; p = p->next ) Nb++;
+    if ( Nb >= SOFT_RC_PULSE_OUT_MAX ) return (0); /* No room in the edge schedule */
     pin    = pinArg;
     angle  = NO_ANGLE;
     pulse0 = 0;
@@ -70,6 +138,7 @@ void SoftRcPulseOut::detach()
     {
       *p = this->next;
       this->next = 0;
+      schedule(); /* The pulse of the current frame (if any) is completed */
       return;
     }
   }
@@ -77,29 +146,27 @@ void SoftRcPulseOut::detach()
 
 void SoftRcPulseOut::write(int angleArg)
 {
+    uint16_t Prev = pulse0;
+
     if ( angleArg < 0)   angleArg = 0;
     if ( angleArg > 180) angleArg = 180;
     angle = angleArg;
     // bleh, have to use longs to prevent overflow, could be tricky if always a 16MHz clock, but not true
-    // That 64L on the end is the TCNT0 prescaler, it will need to change if the clock's prescaler changes,
+    // SOFT_RC_PULSE_OUT_TICK is the prescaler of the millis() timer, it will need to change if the clock's prescaler changes,
     // but then there will likely be an overflow problem, so it will have to be handled by a human.
-#ifdef MS_TIMER_TICK_EVERY_X_CYCLES
-    pulse0 = (min16 * 16L * clockCyclesPerMicrosecond() + (max16 - min16) * (16L * clockCyclesPerMicrosecond()) * angle / 180L) / MS_TIMER_TICK_EVERY_X_CYCLES;
-#else
-    pulse0 = (min16 * 16L * clockCyclesPerMicrosecond() + (max16 - min16) * (16L * clockCyclesPerMicrosecond()) * angle / 180L) / 64L;
-#endif
+    pulse0 = (min16 * 16L * clockCyclesPerMicrosecond() + (max16 - min16) * (16L * clockCyclesPerMicrosecond()) * angle / 180L) / SOFT_RC_PULSE_OUT_TICK;
+    if ( pulse0 != Prev ) schedule();
 }
 
 void SoftRcPulseOut::write_us(uint16_t PulseWidth_us)
 {
+    uint16_t Prev = pulse0;
+
     if ( PulseWidth_us < (min16 * 16)) PulseWidth_us = (min16 * 16);
     if ( PulseWidth_us > (max16 * 16)) PulseWidth_us = (max16 * 16);
-#ifdef MS_TIMER_TICK_EVERY_X_CYCLES
-    pulse0 = (PulseWidth_us * clockCyclesPerMicrosecond()) / MS_TIMER_TICK_EVERY_X_CYCLES;
-#else
-    pulse0 = (PulseWidth_us * clockCyclesPerMicrosecond()) / 64L;
-#endif
+    pulse0 = usToTicks(PulseWidth_us);
     angle = map(PulseWidth_us, min16 * 16, max16 * 16, 0, 180);
+    if ( pulse0 != Prev ) schedule();
 }
 
 uint8_t SoftRcPulseOut::read()
@@ -109,11 +176,17 @@ uint8_t SoftRcPulseOut::read()
 
 uint16_t SoftRcPulseOut::read_us()
 {
-#ifdef MS_TIMER_TICK_EVERY_X_CYCLES
-    return((pulse0 * MS_TIMER_TICK_EVERY_X_CYCLES) / clockCyclesPerMicrosecond());
-#else
-    return((pulse0 * 64L) / clockCyclesPerMicrosecond());
-#endif
+    return(ticksToUs(pulse0));
+}
+
+uint16_t SoftRcPulseOut::usToTicks(uint16_t us)
+{
+    return(SOFT_RC_PULSE_OUT_US_TO_TICKS(us));
+}
+
+uint16_t SoftRcPulseOut::ticksToUs(uint16_t ticks)
+{
+    return((ticks * SOFT_RC_PULSE_OUT_TICK) / clockCyclesPerMicrosecond());
 }
 
 uint8_t SoftRcPulseOut::attached()
@@ -125,105 +198,191 @@ uint8_t SoftRcPulseOut::attached()
   return (0);
 }
 
-uint8_t SoftRcPulseOut::refresh(bool force /* = false */)
+/*
+ Sort the falling edges once, when a pulse width changes, rather than at every frame.
+ Pins of a same port falling at the same tick share one edge, and all the pins of a port
+ rise with a single write: no more error for the servos at the front of the list.
+*/
+void SoftRcPulseOut::schedule()
 {
-  uint8_t  RefreshDone = 0;
-  uint8_t  count = 0, i = 0;
-  uint16_t base = 0;
-  SoftRcPulseOut *p;
-  static uint32_t lastRefresh = 0;
-  uint32_t m = millis();
-  
-  if(!force)
+  ScheduleSt_t     *s;
+  SoftRcPulseOut   *p;
+  volatile uint8_t *port;
+  uint8_t           mask, i, j, r;
+
+  noInterrupts();
+  pending = 0; /* The ISR no longer swaps: the inactive buffer is ours */
+  interrupts();
+  s = &sched[active ^ 1];
+  s->edges = 0;
+  s->ports = 0;
+  for ( p = first; p != 0; p = p->next )
   {
-    // if we haven't wrapped millis, and 20ms have not passed, then don't do anything
-    if ( (m - lastRefresh) < 20UL ) return(RefreshDone);
+    if ( !p->pulse0 ) continue; /* Not positioned yet */
+    port = portOutputRegister(digitalPinToPort(p->pin));
+    mask = digitalPinToBitMask(p->pin);
+    /* Both edges must fit before the pin is scheduled: a pin raised but never lowered would stay HIGH */
+    for ( r = 0; r < s->ports; r++ ) if ( s->raise[r].port == port ) break;
+    if ( r == SOFT_RC_PULSE_OUT_PORTS ) continue;
+    for ( i = 0; i < s->edges; i++ )
+    {
+      if ( s->edge[i].at == p->pulse0 && s->edge[i].port == port ) break;
+      if ( s->edge[i].at > p->pulse0 ) break;
+    }
+    if ( i < s->edges && s->edge[i].at == p->pulse0 && s->edge[i].port == port )
+    {
+      s->edge[i].mask |= mask; /* Shares the falling edge of another pin */
+    }
+    else
+    {
+      if ( s->edges == SOFT_RC_PULSE_OUT_MAX ) continue;
+      /* Falling edge (insertion sort, ascending order) */
+      for ( j = s->edges; j > i; j-- ) s->edge[j] = s->edge[j - 1];
+      s->edge[i].at   = p->pulse0;
+      s->edge[i].port = port;
+      s->edge[i].mask = mask;
+      s->edges++;
+    }
+    /* Rising edge */
+    if ( r == s->ports )
+    {
+      s->raise[r].port = port;
+      s->raise[r].mask = 0;
+      s->ports++;
+    }
+    s->raise[r].mask |= mask;
   }
-  RefreshDone = 1; //Ok: Refresh will be performed
-  lastRefresh = m;
+  noInterrupts();
+  pending = 1;
+  if ( state == SRV_IDLE && s->edges )
+  {
+    /* First frame at the next compare match */
+    state   = SRV_GAP;
+    srvWait = 0;
+    start();
+  }
+  interrupts();
+}
+
+/* Called with interrupts masked: if the compare interrupt is off, the next compare match is in 2 ticks */
+void SoftRcPulseOut::start()
+{
+  if ( !(SOFT_RC_PULSE_OUT_TIMSK & _BV(SOFT_RC_PULSE_OUT_OCIE)) )
+  {
+    SOFT_RC_PULSE_OUT_OCR = SOFT_RC_PULSE_OUT_TCNT + 2;
+    SOFT_RC_PULSE_OUT_TIFR = _BV(SOFT_RC_PULSE_OUT_OCF);
+    SOFT_RC_PULSE_OUT_TIMSK |= _BV(SOFT_RC_PULSE_OUT_OCIE);
+  }
+}
 
-  for ( p = first; p != 0; p = p->next ) if ( p->pulse0 ) count++;
-  if ( count == 0 ) return(RefreshDone);
+void SoftRcPulseOut::hook(uint16_t (*event)(void))
+{
+  noInterrupts();
+  hookEvent = event;
+  hookWait  = event ? 0 : NO_EVENT;
+  if ( event ) start();
+  interrupts();
+}
 
-  // gather all the SoftRcPulseOuts in an array
-  SoftRcPulseOut *s[count];
-  for ( p = first; p != 0; p = p->next ) if ( p->pulse0) s[i++] = p;
+/* Servo timeline: handle the event due now, return the ticks to the next one */
+static uint16_t servoEvent(void)
+{
+  ScheduleSt_t *s = &sched[active];
+  uint8_t       i;
 
-  // bubblesort the SoftRcPulseOuts by pulse time, ascending order
-  s[0]->ItMasked = 0;
-  for(;;)
+  if ( state == SRV_GAP )
   {
-    uint8_t moved = 0;
-    for ( i = 1; i < count; i++ )
+    /* Start of frame */
+    if ( pending )
     {
-      s[i]->ItMasked = 0;
-      if ( s[i]->pulse0 < s[i - 1]->pulse0 )
-      {
-	SoftRcPulseOut *t = s[i];
-	s[i] = s[i - 1];
-	s[i - 1] = t;
-	moved = 1;
-      }
+      active ^= 1;
+      pending = 0;
+      s = &sched[active];
     }
-    if ( !moved ) break;
+    if ( !s->edges )
+    {
+      state = SRV_IDLE;
+      return(NO_EVENT);
+    }
+    for ( i = 0; i < s->ports; i++ ) *s->raise[i].port |= s->raise[i].mask;
+    frames++;
+    idx   = 0;
+    state = SRV_PULSE;
+    return(s->edge[0].at);
   }
-  for ( i = 1; i < count; i++ )
+  /* Falling edge */
+  *s->edge[idx].port &= ~s->edge[idx].mask;
+  idx++;
+  if ( idx < s->edges ) return(s->edge[idx].at - s->edge[idx - 1].at);
+  state = SRV_GAP;
+  return(FRAME_TICKS - s->edge[idx - 1].at);
+}
+
+/*
+ The compare register follows an absolute timeline (OCR += step), so the ISR latency does not
+ accumulate: every edge of a frame is delayed by the same latency as the rising one.
+ Waits longer than the 8 bit timer are split in steps of MAX_STEP_TICKS.
+ The ISR never waits for an edge: an edge whose match already passed when the next compare value
+ is written is handled at once, so close edges cost no busy loop with the interrupts masked.
+*/
+ISR(SOFT_RC_PULSE_OUT_vect)
+{
+  uint16_t step;
+
+  for(;;)
   {
-    if ( abs(s[i]->pulse0 - s[i - 1]->pulse0) <= 5)
+    if ( !srvWait )  srvWait  = servoEvent();
+    if ( !hookWait ) hookWait = hookEvent();
+    if ( !srvWait || !hookWait ) continue; /* Another event due now */
+    step = (srvWait < hookWait) ? srvWait : hookWait;
+    if ( step == NO_EVENT )
     {
-      s[i]->ItMasked = 1; /* 2 consecutive Pulses are close each other, so do not unmask interrupts between Pulses */
+      SOFT_RC_PULSE_OUT_TIMSK &= ~_BV(SOFT_RC_PULSE_OUT_OCIE);
+      return;
     }
+    if ( step > (MAX_STEP_TICKS + 50) ) step = MAX_STEP_TICKS;
+    if ( srvWait != NO_EVENT )  srvWait  -= step;
+    if ( hookWait != NO_EVENT ) hookWait -= step;
+    SOFT_RC_PULSE_OUT_OCR += (uint8_t)step;
+    SOFT_RC_PULSE_OUT_TIFR = _BV(SOFT_RC_PULSE_OUT_OCF);
+    if ( (uint8_t)(SOFT_RC_PULSE_OUT_TCNT - SOFT_RC_PULSE_OUT_OCR) >= 128 ) return; /* Compare match ahead */
+    /* Already passed (ISR entered late): do not wait a whole timer turn, handle it now */
   }
-  // turn on all the pins
-  // Note the timing error here... when you have many SoftwareServos going, the
-  // ones at the front will get a pulse that is a few microseconds too long.
-  // Figure about 4uS/SoftRcPulseOut after them. This could be compensated, but I feel
-  // it is within the margin of error of software SoftRcPulseOuts that could catch
-  // an extra interrupt handler at any time.
-  noInterrupts();
-  for ( i = 0; i < count; i++ ) digitalWrite( s[i]->pin, 1);
-  interrupts();
+}
 
-  uint8_t start = SOFT_RC_PULSE_OUT_TCNT;
-  uint8_t now = start;
-  uint8_t last = now;
+uint8_t SoftRcPulseOut::refresh(bool force /* = false */)
+{
+  static uint8_t  lastFrames = 0;
+  static uint32_t lastRefresh = 0;
+  uint8_t         RefreshDone;
 
-  // Now wait for each pin's time in turn..
-  for ( i = 0; i < count; i++ )
+  if ( state == SRV_IDLE )
   {
-    uint16_t go = start + s[i]->pulse0;
-#ifndef MS_TIMER_TICK_EVERY_X_CYCLES
-    uint16_t it = go - 4; /* 4 Ticks is OK for UNO @ 16MHz with default prescaler*/ /* Mask Interruptions just before setting down the pin */
-#else
-    uint16_t it = go - max(4, (256 / MS_TIMER_TICK_EVERY_X_CYCLES)); /* 4 Ticks is OK for UNO @ 16MHz */ /* Mask Interruptions just before setting down the pin */
-#endif
-    // loop until we reach or pass 'go' time: this is a blocking loop (max 2400us) except for non masked ISR (between edges)
-    for (;;)
+    /* No pulse to generate: keep the 20ms timer */
+    uint32_t m = millis();
+    if ( !force && (m - lastRefresh) < 20UL ) return(0);
+    lastRefresh = m;
+    return(1);
+  }
+  if ( force )
+  {
+    noInterrupts();
+    if ( state == SRV_GAP )
     {
-      now = SOFT_RC_PULSE_OUT_TCNT;
-      if ( now < last ) base += 256;
-      last = now;
-      if( !s[i]->ItMasked )
-      {
-	if( base + now > it)
-	{
-	  noInterrupts();
-	  s[i]->ItMasked = 1;
-	}
-      }
-      if ( base + now > go )
+      /* Start the next frame now, or at the next compare match if a hook shares the timeline */
+      srvWait = 0;
+      if ( hookWait == NO_EVENT )
       {
-	digitalWrite( s[i]->pin, 0);
-	if( (i + 1) < count )
-	{
-	  if( !s[i + 1]->ItMasked )
-	  {
-	    interrupts();
-	  }
-	}else interrupts();
-	break;
+        SOFT_RC_PULSE_OUT_OCR = SOFT_RC_PULSE_OUT_TCNT + 2;
+        SOFT_RC_PULSE_OUT_TIFR = _BV(SOFT_RC_PULSE_OUT_OCF);
       }
+      lastFrames = frames + 1; /* This frame is the refresh */
     }
+    else lastFrames = frames;  /* Pulses in progress: this frame is the refresh */
+    interrupts();
+    return(1);
   }
+  RefreshDone = (frames != lastFrames);
+  lastFrames = frames;
   return(RefreshDone);
 }
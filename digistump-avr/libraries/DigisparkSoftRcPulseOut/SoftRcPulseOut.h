@@ -4,14 +4,16 @@
 /*
  Update 01/03/2013: add support for Digispark (http://digistump.com): automatic Timer selection (RC Navy: p.loussouarn.free.fr)
  Update 19/08/2014: usage with write_us and read_us fixed and optimized for highest resolution
+ Update 19/10/2026: pulses generated by a compare match ISR of the millis() timer: refresh() no longer blocks
 
  English: by RC Navy (2012)
  =======
  <SoftRcPulseOut>: a library mainly based on the <SoftwareServo> library, but with a better pulse generation to limit jitter.
  It supports the same methods as <SoftwareServo>.
  It also support Pulse Width order given in microseconds. The current Pulse Width can also be read in microseconds.
- The refresh method can admit an optionnal argument (force). If SoftRcPulseOut::refresh(1) is called, the refresh is forced even if 20 ms are not elapsed.
- The refresh() method returns 1 if refresh done (can be used for synchro and/or for 20ms timer).
+ The pulses are generated every 20 ms by a compare match interrupt of the millis() timer: calling refresh() is no longer required.
+ The refresh method can admit an optionnal argument (force). If SoftRcPulseOut::refresh(1) is called, the next frame starts at once even if 20 ms are not elapsed.
+ The refresh() method returns 1 once per frame (can be used for synchro and/or for 20ms timer).
  http://p.loussouarn.free.fr
 
  Francais: par RC Navy (2012)
@@ -19,8 +21,9 @@
  <SoftRcPulseOut>: une librairie majoritairement basee sur la librairie <SoftwareServo>, mais avec une meilleure generation des impulsions pour limiter la gigue.
  Elle supporte les memes methodes que <SoftwareServo>.
  Elle supporte egalement une consigne de largeur d'impulsion passee en microseconde. La largeur de l'impulsion courante peut egalement etre lue en microseconde.
- La methode refresh peut admettre un parametre optionnel (force). Si SoftRcPulseOut::resfresh(1) est appelee, le refresh est force meme si 20 ms ne se sont pas ecoulee.
- La methode refresh() retourne 1 si refresh effectue (peut etre utilise pour synhro et/ou 20ms timer).
+ Les impulsions sont generees toutes les 20 ms par une interruption de comparaison du timer de millis(): appeler refresh() n'est plus necessaire.
+ La methode refresh peut admettre un parametre optionnel (force). Si SoftRcPulseOut::resfresh(1) est appelee, la trame suivante demarre aussitot meme si 20 ms ne se sont pas ecoulee.
+ La methode refresh() retourne 1 une fois par trame (peut etre utilise pour synhro et/ou 20ms timer).
  http://p.loussouarn.free.fr
 */
 
@@ -32,10 +35,24 @@
 
 #include <inttypes.h>
 
+/* Cycles per tick of the millis() timer, which times the pulses */
+#ifdef MS_TIMER_TICK_EVERY_X_CYCLES
+#define SOFT_RC_PULSE_OUT_TICK  MS_TIMER_TICK_EVERY_X_CYCLES
+#else
+#define SOFT_RC_PULSE_OUT_TICK  64L
+#endif
+
+/* Same as SoftRcPulseOut::usToTicks(), folded at compile time for a constant */
+#define SOFT_RC_PULSE_OUT_US_TO_TICKS(us)  ((uint16_t)(((us) * clockCyclesPerMicrosecond()) / SOFT_RC_PULSE_OUT_TICK))
+
+/* Maximum number of attached SoftRcPulseOut (size of the edge schedule) */
+#ifndef SOFT_RC_PULSE_OUT_MAX
+#define SOFT_RC_PULSE_OUT_MAX 8
+#endif
+
 class SoftRcPulseOut
 {
   private:
-    boolean        ItMasked;
     uint8_t        pin;
     uint8_t        angle;      // in degrees
     uint16_t       pulse0;     // pulse width in TCNT0 counts
@@ -43,10 +60,14 @@ class SoftRcPulseOut
     uint8_t        max16;      // maximum pulse, 16uS units, 0-4ms range (default is 150)
     class          SoftRcPulseOut *next;
     static         SoftRcPulseOut *first;
+    static void    schedule();         // rebuild the edge schedule used by the timer ISR
+    static void    start();            // enable the compare interrupt if needed
   public:
     SoftRcPulseOut();
-    uint8_t        attach(int);        // attach to a pin, sets pinMode, returns 0 on failure, won't
-                                       // position the servo until a subsequent write() happens
+    uint8_t        attach(int);        // attach to a pin, sets pinMode, returns 0 on failure (SOFT_RC_PULSE_OUT_MAX
+                                       // servos already attached), won't position the servo until a subsequent
+                                       // write() happens. The servos may use SOFT_RC_PULSE_OUT_PORTS ports at most,
+                                       // the pins of another port are left LOW
     void           detach();
     void           write(int);         // specify the angle in degrees, 0 to 180
     void           write_us(uint16_t); // specify the angle in microseconds, 500 to 2500
@@ -55,8 +76,12 @@ class SoftRcPulseOut
     uint8_t        attached();
     void           setMinimumPulse(uint16_t);  // pulse length for 0 degrees in microseconds, 540uS default
     void           setMaximumPulse(uint16_t);  // pulse length for 180 degrees in microseconds, 2400uS default
-    static uint8_t refresh(bool force = false);// must be called at least every 50ms or so to keep servo alive
-                                               // you can call more often, it won't happen more than once every 20ms
+    static uint8_t refresh(bool force = false);// returns 1 once per 20ms frame (the pulses are generated by a timer ISR,
+                                               // calling it is not needed to keep the servos alive), force starts a new frame now
+    static void    hook(uint16_t (*event)(void)); // share the compare interrupt with another pulse train: event() is called
+                                               // at each of its edges and returns the ticks to the next one (0xFFFF: stop)
+    static uint16_t usToTicks(uint16_t us);    // timer ticks of the ISR
+    static uint16_t ticksToUs(uint16_t ticks);
 };
 
 /*      Methodes en Francais                    English native methods */
@@ -0,0 +1,38 @@
+// PpmSweep
+// 8 channels PPM sum signal on a single pin: channel 1 sweeps, the others stay at neutral (1500us).
+// A servo is driven at the same time: both share the same compare interrupt.
+// This sketch can work with ATtiny and Arduino UNO, MEGA, etc...
+// This example code is in the public domain.
+
+#include <SoftRcPulseOut.h>
+#include <SoftRcPpmOut.h>
+
+SoftRcPpmOut ppm;
+SoftRcPulseOut myservo;
+
+#define PPM_PIN           1
+#define SERVO_PIN         0
+
+#define WIDTH_MIN_US      1000
+#define WIDTH_MAX_US      2000
+
+int width = WIDTH_MIN_US;
+int step = 10;
+
+void setup()
+{
+  ppm.attach(PPM_PIN);        // 8 channels, positive separator pulses
+  myservo.attach(SERVO_PIN);
+}
+
+void loop()
+{
+  if (SoftRcPulseOut::refresh())    // refresh() returns 1 every 20ms
+  {
+    width += step;
+    if(width >= WIDTH_MAX_US) step = -10;
+    if(width <= WIDTH_MIN_US) step = +10;
+    ppm.write_us(1, width);
+    myservo.write_us(width);
+  }
+}
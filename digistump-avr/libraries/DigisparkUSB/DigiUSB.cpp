@@ -43,7 +43,7 @@ ring_buffer tx_buffer = { { 0 }, 0, 0 };
 
 inline int store_char(unsigned char c, ring_buffer *the_buffer)
 {
-  int i = (the_buffer->head + 1) % RING_BUFFER_SIZE;
+  uint8_t i = (the_buffer->head + 1) & RING_BUFFER_MASK;
 
   // if we should be storing the received character into the location
   // just before the tail (meaning that the head would advance to the
@@ -78,6 +78,12 @@ void DigiUSBDevice::begin() {
     usbDeviceConnect();
     
     sei();
+
+    schedulerSetService(usbPoll, SCHEDULER_USB_INTERVAL_US);
+#if USB_COUNT_SOF && USB_INTR_CFG_SET == (1 << USB_CFG_DMINUS_BIT)
+    // keep-alives are only seen with the interrupt on D-
+    schedulerSetFrameCounter(&usbSofCount);
+#endif
   }
     
 // TODO: Deprecate update
@@ -91,24 +97,21 @@ void DigiUSBDevice::refresh() {
 }
 
 // wait a specified number of milliseconds (roughly), refreshing in the background
+// and running the schedulerAdd() tasks
 void DigiUSBDevice::delay(long milli) {
-  unsigned long last = millis();
-  while (milli > 0) {
-    unsigned long now = millis();
-    milli -= now - last;
-    last = now;
-    refresh();
+  if (milli > 0) {
+    schedulerDelay(milli);
   }
 }
 
 int DigiUSBDevice::available() {
   /*
    */
-  return (RING_BUFFER_SIZE + _rx_buffer->head - _rx_buffer->tail) % RING_BUFFER_SIZE;
+  return (uint8_t)(_rx_buffer->head - _rx_buffer->tail) & RING_BUFFER_MASK;
 }
 
 int DigiUSBDevice::tx_remaining() {
-  return RING_BUFFER_SIZE - (RING_BUFFER_SIZE + _tx_buffer->head - _tx_buffer->tail) % RING_BUFFER_SIZE;
+  return (uint8_t)(_tx_buffer->tail - _tx_buffer->head - 1) & RING_BUFFER_MASK;
 }
   
 int DigiUSBDevice::read() {
@@ -119,7 +122,7 @@ int DigiUSBDevice::read() {
     return -1;
   } else {
     unsigned char c = _rx_buffer->buffer[_rx_buffer->tail];
-    _rx_buffer->tail = (_rx_buffer->tail + 1) % RING_BUFFER_SIZE;
+    _rx_buffer->tail = (_rx_buffer->tail + 1) & RING_BUFFER_MASK;
     return c;
   }
 }
@@ -135,7 +138,7 @@ size_t DigiUSBDevice::write(byte c) {
 int tx_available() {
   /*
    */
-  return (RING_BUFFER_SIZE + tx_buffer.head - tx_buffer.tail) % RING_BUFFER_SIZE;
+  return (uint8_t)(tx_buffer.head - tx_buffer.tail) & RING_BUFFER_MASK;
 }
 
 int tx_read() {
@@ -146,11 +149,15 @@ int tx_read() {
     return -1;
   } else {
     unsigned char c = tx_buffer.buffer[tx_buffer.tail];
-    tx_buffer.tail = (tx_buffer.tail + 1) % RING_BUFFER_SIZE;
+    tx_buffer.tail = (tx_buffer.tail + 1) & RING_BUFFER_MASK;
     return c;
   } 
 }
 
+int rx_remaining() {
+  return (uint8_t)(rx_buffer.tail - rx_buffer.head - 1) & RING_BUFFER_MASK;
+}
+
 
 
 
@@ -180,6 +187,9 @@ PROGMEM const uchar usbHidReportDescriptor[22] = {    /* USB report descriptor *
 
 /* ------------------------------------------------------------------------- */
 
+static uchar bytesRemaining;   /* of the DIGIUSB_RQ_WRITE transfer */
+static uchar writeRefused;     /* DIGIUSB_RQ_WRITE did not fit into rx_buffer */
+
 usbMsgLen_t usbFunctionSetup(uchar data[8])
 {
   usbRequest_t    *rq = (usbRequest_t*)((void *)data);
@@ -202,11 +212,57 @@ usbMsgLen_t usbFunctionSetup(uchar data[8])
 	  store_char(rq->wIndex.bytes[0], &rx_buffer);
 
         }
-    }else{
-        /* ignore vendor type requests, we don't use any */
+    }else if((rq->bmRequestType & USBRQ_TYPE_MASK) == USBRQ_TYPE_VENDOR){
+        if(rq->bRequest == DIGIUSB_RQ_READ){
+            return USB_NO_MSG;  /* usbFunctionRead() empties tx_buffer */
+        }else if(rq->bRequest == DIGIUSB_RQ_WRITE){
+            /* all or nothing, so that a stalled transfer can simply be repeated */
+            writeRefused = rq->wLength.word > (unsigned)rx_remaining();
+            bytesRemaining = rq->wLength.bytes[0];
+            if(!rq->wLength.word)
+                return 0;
+            return USB_NO_MSG;  /* usbFunctionWrite() fills rx_buffer */
+        }else if(rq->bRequest == DIGIUSB_RQ_STATUS){
+            static uchar status[2];
+            status[0] = tx_available();
+            status[1] = rx_remaining();
+            usbMsgPtr = status;
+            return 2;
+        }
     }
     return 0;
 }
+
+/* Called for each chunk of up to 8 bytes of DIGIUSB_RQ_READ, a chunk shorter
+ * than 'len' ends the transfer.
+ */
+uchar usbFunctionRead(uchar *data, uchar len)
+{
+    uchar n = 0;
+    uint8_t tail = tx_buffer.tail;
+
+    while(n < len && tail != tx_buffer.head){
+        data[n++] = tx_buffer.buffer[tail];
+        tail = (tail + 1) & RING_BUFFER_MASK;
+    }
+    tx_buffer.tail = tail;
+    return n;
+}
+
+/* Called for each chunk of up to 8 bytes of DIGIUSB_RQ_WRITE, returns 1 when
+ * the last one was received, 0xff to stall the transfer.
+ */
+uchar usbFunctionWrite(uchar *data, uchar len)
+{
+    if(writeRefused)
+        return 0xff;
+    if(len > bytesRemaining)
+        len = bytesRemaining;
+    bytesRemaining -= len;
+    while(len--)
+        store_char(*data++, &rx_buffer);
+    return bytesRemaining == 0;
+}
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -17,16 +17,41 @@ typedef uint8_t byte;
 
 #include <util/delay.h>     /* for _delay_ms() */
 
+// Size of each of the receive and transmit buffers, a power of two up to 256.
+// One byte of each is kept free to tell a full buffer from an empty one.
+// Change it here: a #define in the sketch does not reach DigiUSB.cpp.
 #define RING_BUFFER_SIZE 128
 
+#if (RING_BUFFER_SIZE & (RING_BUFFER_SIZE - 1)) || RING_BUFFER_SIZE > 256
+#error RING_BUFFER_SIZE must be a power of two, 256 at most
+#endif
+
+#define RING_BUFFER_MASK (RING_BUFFER_SIZE - 1)
+
 
 struct ring_buffer {
   unsigned char buffer[RING_BUFFER_SIZE];
-  int head;
-  int tail;
+  uint8_t head;
+  uint8_t tail;
 };
 
 
+// Vendor requests to device, moving up to RING_BUFFER_SIZE - 1 bytes (127)
+// per control transfer.
+// The HID feature report (GET_REPORT/SET_REPORT, one byte per transfer) of
+// the old host tools keeps working alongside.
+//
+// DIGIUSB_RQ_READ   IN, wLength bytes at most: the bytes waiting in the
+//                   transmit buffer, a short reply when it ran empty
+// DIGIUSB_RQ_WRITE  OUT, wLength bytes: stalls, storing nothing, if the
+//                   receive buffer has less room than that (retry later)
+// DIGIUSB_RQ_STATUS IN, 2 bytes: bytes waiting to be read by the host,
+//                   room in the receive buffer
+#define DIGIUSB_RQ_READ   1
+#define DIGIUSB_RQ_WRITE  2
+#define DIGIUSB_RQ_STATUS 3
+
+
 
 
 
@@ -0,0 +1,29 @@
+// Streams log lines as fast as DigiUSB can move them.
+// Watch them with:  python3 extras/digiusb.py --stats
+// The tool reads whatever the transmit buffer holds (127 bytes with the default
+// RING_BUFFER_SIZE of DigiUSB.h) in one transfer, so keeping it full gives several
+// kB/s instead of the few hundred bytes/s of the one byte per transfer tools.
+
+#include <DigiUSB.h>
+
+unsigned long line = 0;
+
+void setup() {
+  DigiUSB.begin();
+}
+
+void loop() {
+  // only write whole lines, so that none is cut when the buffer is full
+  if (DigiUSB.tx_remaining() >= 24) {
+    DigiUSB.print(line++);
+    DigiUSB.print(F(" P2="));
+    DigiUSB.println(analogRead(1));
+  }
+
+  // anything typed into the tool comes back as an echo
+  while (DigiUSB.available()) {
+    DigiUSB.write(DigiUSB.read());
+  }
+
+  DigiUSB.refresh();
+}
@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+"""
+Terminal for DigiUSB: prints what the sketch writes, sends what is typed (or piped) to it.
+
+    python3 extras/digiusb.py [--legacy] [--stats]
+
+Needs pyusb (pip install pyusb), a POSIX system (stdin is polled with select) and, on Linux,
+permission to access the device (a udev rule for 16c0:05df or root).
+
+Firmware with DIGIUSB_RQ_READ/DIGIUSB_RQ_WRITE (see DigiUSB.h) moves up to 127 bytes per
+control transfer, older firmware and --legacy one byte per HID feature report transfer.
+"""
+
+import argparse
+import os
+import select
+import sys
+import time
+
+import usb.core
+
+VENDOR_ID = 0x16c0
+PRODUCT_ID = 0x05df
+PRODUCT = 'DigiUSB'
+
+# Must match DigiUSB.h
+DIGIUSB_RQ_READ = 1
+DIGIUSB_RQ_WRITE = 2
+DIGIUSB_RQ_STATUS = 3
+MAX_TRANSFER = 127              # RING_BUFFER_SIZE - 1 with the default RING_BUFFER_SIZE
+
+VENDOR_IN = 0xC0
+VENDOR_OUT = 0x40
+HID_GET_REPORT = (0xA0, 0x01)
+HID_SET_REPORT = (0x20, 0x09)
+TIMEOUT_MS = 1000
+
+
+def find_device():
+    for dev in usb.core.find(find_all=True, idVendor=VENDOR_ID, idProduct=PRODUCT_ID):
+        try:
+            if dev.product == PRODUCT:
+                return dev
+        except (ValueError, usb.core.USBError):
+            pass
+    return None
+
+
+class DigiUSB:
+    def __init__(self, dev, legacy):
+        self.dev = dev
+        self.legacy = legacy or not self.status()
+
+    def status(self):
+        """(bytes waiting for the host, room for the device), None if the firmware has no DIGIUSB_RQ_STATUS"""
+        try:
+            data = self.dev.ctrl_transfer(VENDOR_IN, DIGIUSB_RQ_STATUS, 0, 0, 2, TIMEOUT_MS)
+        except usb.core.USBError:
+            return None
+        return tuple(data) if len(data) == 2 else None
+
+    def read(self):
+        if self.legacy:
+            data = bytearray()
+            while len(data) < MAX_TRANSFER:
+                try:
+                    byte = self.dev.ctrl_transfer(HID_GET_REPORT[0], HID_GET_REPORT[1], 0, 0, 1, TIMEOUT_MS)
+                except usb.core.USBError:
+                    break
+                if not len(byte):
+                    break
+                data += bytes(byte)
+            return bytes(data)
+        return bytes(self.dev.ctrl_transfer(VENDOR_IN, DIGIUSB_RQ_READ, 0, 0, MAX_TRANSFER, TIMEOUT_MS))
+
+    def write(self, data):
+        """Sends all of 'data', waiting while the receive buffer of the sketch is full"""
+        while data:
+            if self.legacy:
+                self.dev.ctrl_transfer(HID_SET_REPORT[0], HID_SET_REPORT[1], 0, data[0], None, TIMEOUT_MS)
+                data = data[1:]
+                continue
+            status = self.status()
+            room = min(status[1] if status else 0, MAX_TRANSFER)
+            if not room:
+                time.sleep(0.005)
+                continue
+            try:
+                self.dev.ctrl_transfer(VENDOR_OUT, DIGIUSB_RQ_WRITE, 0, 0, data[:room], TIMEOUT_MS)
+            except usb.core.USBError:
+                time.sleep(0.005)  # stalled: the sketch has not read enough yet
+                continue
+            data = data[room:]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('--legacy', action='store_true', help='one byte per transfer, for old firmware')
+    parser.add_argument('--stats', action='store_true', help='print the received bytes per second to stderr')
+    args = parser.parse_args()
+
+    dev = find_device()
+    if dev is None:
+        sys.exit('No DigiUSB device found')
+    digi = DigiUSB(dev, args.legacy)
+    sys.stderr.write('Connected (%s transfers)\n' % ('1 byte' if digi.legacy else '%d byte' % MAX_TRANSFER))
+
+    stdin = sys.stdin.fileno()
+    stdin_open = True
+    received = 0
+    started = time.time()
+    while True:
+        data = digi.read()
+        if data:
+            received += len(data)
+            sys.stdout.buffer.write(data)
+            sys.stdout.flush()
+        elif stdin_open and select.select([stdin], [], [], 0.001)[0]:
+            line = os.read(stdin, MAX_TRANSFER)
+            if line:
+                digi.write(line)
+            else:
+                stdin_open = False
+        else:
+            time.sleep(0.001)
+        if args.stats and time.time() - started >= 1:
+            sys.stderr.write('%d bytes/s\n' % (received / (time.time() - started)))
+            received = 0
+            started = time.time()
+
+
+if __name__ == '__main__':
+    try:
+        main()
+    except KeyboardInterrupt:
+        pass
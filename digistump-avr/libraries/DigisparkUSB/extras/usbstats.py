@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+"""
+Print the driver counters of Digispark USB devices built with USB_CFG_HAVE_STATS 1.
+
+    python3 extras/usbstats.py [--interval SECONDS] [--product NAME]
+
+Works with every library of the V-USB family (DigiUSB, DigiKeyboard, DigiMouse, DigiJoystick,
+DigiCDC): the driver answers the vendor request USB_CFG_STATS_REQUEST itself. The counters wrap
+around at 65536, so each line shows the changes since the previous read. Only devices with the
+ids of those libraries and the manufacturer string digistump.com are asked. Needs pyusb and, on
+Linux, permission to access the device.
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+import usb.core
+
+# (vendor id, product id) of the V-USB libraries: DigiUSB (the shared V-USB HID id), DigiMouse,
+# DigiKeyboard, DigiJoystick and DigiCDC. Other V-USB devices (USBasp...) use the same vendor
+# id and may give the request another meaning, so the manufacturer string is checked as well.
+DEVICE_IDS = ((0x16c0, 0x05df), (0x16c0, 0x27da), (0x16c0, 0x27db), (0x16c0, 0x27dc), (0x16d0, 0x087e))
+MANUFACTURER = 'digistump.com'
+
+# Must match usbconfig.h and usbStats_t of usbdrv.h
+USB_CFG_STATS_REQUEST = 0x53
+FIELDS = ('rxPackets', 'txPackets', 'crcErrors', 'intrNaks', 'resets', 'maxIrqLatency')
+
+VENDOR_IN = 0xC0
+TIMEOUT_MS = 1000
+
+
+def read_stats(dev):
+    """usbStats as a dict, None if the firmware does not answer the request"""
+    try:
+        data = dev.ctrl_transfer(VENDOR_IN, USB_CFG_STATS_REQUEST, 0, 0, 2 * len(FIELDS), TIMEOUT_MS)
+    except usb.core.USBError:
+        return None
+    if len(data) != 2 * len(FIELDS):
+        return None
+    return dict(zip(FIELDS, struct.unpack('<%dH' % len(FIELDS), bytes(data))))
+
+
+def product(dev):
+    """product string of a Digispark device, None for other devices"""
+    if (dev.idVendor, dev.idProduct) not in DEVICE_IDS:
+        return None
+    try:
+        if dev.manufacturer != MANUFACTURER:
+            return None
+        return dev.product or ''
+    except (ValueError, usb.core.USBError):
+        return None
+
+
+def name(dev, prod):
+    return '%s %03d/%03d' % (prod, dev.bus, dev.address)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('--interval', type=float, default=1.0, help='seconds between two reads')
+    parser.add_argument('--product', help='only devices with this product string (all of it)')
+    args = parser.parse_args()
+
+    last = {}
+    while True:
+        found = False
+        for dev in usb.core.find(find_all=True):
+            prod = product(dev)
+            if prod is None or (args.product and prod != args.product):
+                continue
+            stats = read_stats(dev)
+            if stats is None:
+                continue
+            found = True
+            key = (dev.bus, dev.address)
+            if key in last:
+                delta = ['%s +%d' % (f, (stats[f] - last[key][f]) & 0xFFFF) for f in FIELDS[:-1]]
+                print('%s: %s, maxIrqLatency %d us' % (name(dev, prod), ', '.join(delta), stats['maxIrqLatency']))
+            last[key] = stats
+        if not found:
+            sys.stderr.write('No device with USB_CFG_HAVE_STATS found\n')
+        sys.stdout.flush()
+        time.sleep(args.interval)
+
+
+if __name__ == '__main__':
+    try:
+        main()
+    except KeyboardInterrupt:
+        pass
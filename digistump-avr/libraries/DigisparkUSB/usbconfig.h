@@ -89,12 +89,12 @@ section at the end of this file).
  * The value is in milliamperes. [It will be divided by two since USB
  * communicates power requirements in units of 2 mA.]
  */
-#define USB_CFG_IMPLEMENT_FN_WRITE      0
+#define USB_CFG_IMPLEMENT_FN_WRITE      1
 /* Set this to 1 if you want usbFunctionWrite() to be called for control-out
  * transfers. Set it to 0 if you don't need it and want to save a couple of
  * bytes.
  */
-#define USB_CFG_IMPLEMENT_FN_READ       0
+#define USB_CFG_IMPLEMENT_FN_READ       1
 /* Set this to 1 if you need to send control replies which are generated
  * "on the fly" when usbFunctionRead() is called. If you only want to send
  * data from a static buffer, set it to 0 and return the data from
@@ -164,7 +164,21 @@ section at the end of this file).
  * usbFunctionWrite(). Use the global usbCurrentDataToken and a static variable
  * for each control- and out-endpoint to check for duplicate packets.
  */
+#define USB_CFG_HAVE_STATS              0
+/* define this macro to 1 to count packets, CRC errors, NAKed interrupt-in
+ * polls, bus resets and the longest interrupt latency in the global usbStats
+ * (see usbdrv.h). The host reads them with the vendor request below, which
+ * the driver answers itself. Costs about 16 bytes of RAM.
+ */
+#define USB_CFG_STATS_REQUEST           0x53
+/* bRequest of the vendor IN request that reads usbStats. Must not be used by
+ * usbFunctionSetup().
+ */
 #define USB_CFG_HAVE_MEASURE_FRAME_LENGTH   1
+#define USB_CFG_OSCCAL_TRACKING             1
+/* define this macro to 1 to keep OSCCAL calibrated while the device runs,
+ * see osccal.h. Each measurement disables interrupts for one frame (1 ms).
+ */
 #include "osccal.h"
 /* define this macro to 1 if you want the function usbMeasureFrameLength()
  * compiled in. This function can be used to calibrate the AVR's RC oscillator.
@@ -0,0 +1,42 @@
+/***
+    eeprom_put_async example.
+
+    This shows how to use the EEPROM.putAsync() method.
+
+    EEPROM.put() waits for every byte to be programmed, up to
+    3.4 ms each, which is far too long for sketches that must
+    keep running, like the V-USB ones. EEPROM.putAsync() returns
+    at once and the bytes are programmed from an interrupt.
+
+    The object is not copied, so it has to be a global (or static)
+    variable that stays valid until EEPROM.busy() returns false.
+***/
+
+#include <EEPROM.h>
+
+struct Config {
+  byte brightness;
+  byte mode;
+  unsigned int interval;
+  char name[12];
+};
+
+Config config;
+
+void setup() {
+  pinMode(1, OUTPUT);
+  EEPROM.get(0, config);
+}
+
+void loop() {
+  static unsigned long last = 0;
+
+  if (millis() - last >= 10000) {
+    last = millis();
+    config.brightness++;
+    EEPROM.putAsync(0, config);   // returns immediately
+  }
+
+  // the loop keeps running while the EEPROM is programmed
+  digitalWrite(1, EEPROM.busy());
+}
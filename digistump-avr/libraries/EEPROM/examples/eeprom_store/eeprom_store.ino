@@ -0,0 +1,39 @@
+/***
+    eeprom_store example.
+
+    This shows how to use EEStore to keep a counter in the EEPROM
+    that is updated every second without wearing out a single cell
+    and without stopping the sketch while the EEPROM is programmed.
+
+    The first 256 bytes of the EEPROM are used: 36 records of 4 bytes.
+    Each record is programmed once every 36 updates, so the counter
+    lasts 36 times longer than in a fixed cell.
+***/
+
+#include <EEPROMStore.h>
+
+#define KEY_UPTIME 1
+#define KEY_BOOTS  2
+
+EEStore store( 0, 256, sizeof(unsigned long) );
+unsigned long uptime = 0;
+
+void setup() {
+  unsigned long boots = 0;
+
+  pinMode(1, OUTPUT);
+  store.begin();
+  store.get( KEY_UPTIME, uptime );
+  store.get( KEY_BOOTS, boots );
+  store.put( KEY_BOOTS, boots + 1 );
+}
+
+void loop() {
+  static unsigned long last = 0;
+
+  if ( millis() - last >= 1000 ) {
+    last += 1000;
+    store.put( KEY_UPTIME, ++uptime );  // queued, programmed in the background
+  }
+  digitalWrite( 1, store.busy() );      // LED on while the EEPROM is programmed
+}
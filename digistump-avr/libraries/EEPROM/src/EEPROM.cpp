@@ -0,0 +1,56 @@
+/*
+  EEPROM.cpp - EEPROM library
+  Original Copyright (c) 2006 David A. Mellis.  All right reserved.
+  New version by Christopher Andrews 2015.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <avr/interrupt.h>
+#include "EEPROM.h"
+
+/***
+    Wait until no byte is being programmed, then return with interrupts disabled,
+    so the EEPROMQueue interrupt can not start the next byte behind our back.
+    Returns the SREG to restore.
+***/
+
+static uint8_t ee_lock(){
+    uint8_t sreg = SREG;
+    for(;;){
+        while( EECR & _BV( EEPE ) );
+        cli();
+        if( !( EECR & _BV( EEPE ) ) ) return sreg;
+        SREG = sreg;
+    }
+}
+
+uint8_t ee_read( int index ){
+    uint8_t sreg = ee_lock();
+    uint8_t val;
+
+    EEAR = index;
+    EECR |= _BV( EERE );
+    val = EEDR;
+    SREG = sreg;
+    return val;
+}
+
+void ee_write( int index, uint8_t in ){
+    uint8_t sreg = ee_lock();
+
+    eeprom_program( index, in );
+    SREG = sreg;
+}
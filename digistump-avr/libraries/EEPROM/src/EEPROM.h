@@ -24,6 +24,16 @@
 #include <inttypes.h>
 #include <avr/eeprom.h>
 #include <avr/io.h>
+#include "EEPROMQueue.h"
+
+/***
+    Single byte access, safe to use while EEQueue programs from its interrupt.
+    ee_write() uses the shortest programming mode (see eeprom_program()) and does
+    not wait for the programming to finish.
+***/
+
+uint8_t ee_read( int index );
+void ee_write( int index, uint8_t in );
 
 /***
     EERef class.
@@ -39,12 +49,12 @@ struct EERef{
         : index( index )                 {}
     
     //Access/read members.
-    uint8_t operator*() const            { return eeprom_read_byte( (uint8_t*) index ); }
+    uint8_t operator*() const            { return ee_read( index ); }
     operator uint8_t() const             { return **this; }
     
     //Assignment/write members.
     EERef &operator=( const EERef &ref ) { return *this = *ref; }
-    EERef &operator=( uint8_t in )       { return eeprom_write_byte( (uint8_t*) index, in ), *this;  }
+    EERef &operator=( uint8_t in )       { return ee_write( index, in ), *this;  }
     EERef &operator +=( uint8_t in )     { return *this = **this + in; }
     EERef &operator -=( uint8_t in )     { return *this = **this - in; }
     EERef &operator *=( uint8_t in )     { return *this = **this * in; }
@@ -140,6 +150,16 @@ struct EEPROMClass{
         for( int count = sizeof(T) ; count ; --count, ++e )  (*e).update( *ptr++ );
         return t;
     }
+
+    //Non-blocking writes, programmed from the EE_READY interrupt (see EEPROMQueue.h).
+    //putAsync() does not copy 't', it must stay valid until busy() returns false.
+    void writeAsync( int idx, uint8_t val ) { EEQueue::write( idx, val ); }
+    template< typename T > const T &putAsync( int idx, const T &t ){
+        EEQueue::writeBlock( idx, &t, sizeof(T) );
+        return t;
+    }
+    bool busy()                          { return EEQueue::busy(); }
+    void flush()                         { EEQueue::flush(); }
 };
 
 static EEPROMClass EEPROM;
@@ -0,0 +1,164 @@
+/*
+  EEPROMQueue.cpp - interrupt driven EEPROM write queue
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <avr/interrupt.h>
+#include "EEPROMQueue.h"
+
+#if !defined(EE_READY_vect) && defined(EE_RDY_vect)
+#define EE_READY_vect EE_RDY_vect
+#endif
+
+#define QUEUE_MASK (EEPROM_QUEUE_SIZE - 1)
+
+static uint16_t          qAddr[EEPROM_QUEUE_SIZE];
+static uint8_t           qData[EEPROM_QUEUE_SIZE];
+static volatile uint8_t  qHead;         //Next free entry, written by write() only.
+static volatile uint8_t  qTail;         //Next entry to program, written by the ISR only.
+
+static const uint8_t     *bSrc;         //Object of writeBlock().
+static uint16_t          bAddr;
+static uint16_t          bLen;
+static volatile uint16_t bPos;          //Next byte of the object, bLen when done.
+static uint8_t           bMark;         //qHead when the object was queued.
+
+/***
+    Start programming the next byte that differs from the EEPROM content, in the
+    order the bytes were queued: the object comes after the single bytes queued
+    before it (up to bMark) and before those queued after it.
+    Called with interrupts disabled and no programming in progress.
+    Returns false if there was nothing left to program.
+***/
+
+static bool programNext(){
+    for(;;){
+        if( bPos < bLen && qTail == bMark ){
+            uint16_t p = bPos++;
+            if( eeprom_program( bAddr + p, bSrc[ p ] ) ) return true;
+        }else if( qTail != qHead ){
+            uint8_t t = qTail;
+            qTail = ( t + 1 ) & QUEUE_MASK;
+            if( eeprom_program( qAddr[ t ], qData[ t ] ) ) return true;
+        }else{
+            return false;
+        }
+    }
+}
+
+ISR( EE_READY_vect ){
+    if( !programNext() ) EECR = 0;       //Interrupt off, back to erase and write mode.
+}
+
+void EEQueue::write( uint16_t addr, uint8_t val ){
+    for(;;){
+        uint8_t sreg = SREG;
+        cli();
+
+        //Coalesce with a byte still waiting for the same cell, unless the pending
+        //object comes between them: it must not overwrite the newer value.
+        for( uint8_t i = bPos < bLen ? bMark : qTail ; i != qHead ; i = ( i + 1 ) & QUEUE_MASK ){
+            if( qAddr[ i ] == addr ){
+                qData[ i ] = val;
+                SREG = sreg;
+                return;
+            }
+        }
+
+        uint8_t next = ( qHead + 1 ) & QUEUE_MASK;
+        if( next != qTail ){
+            qAddr[ qHead ] = addr;
+            qData[ qHead ] = val;
+            qHead = next;
+            EECR |= _BV( EERIE );        //Fires at once if no byte is being programmed.
+            SREG = sreg;
+            return;
+        }
+        SREG = sreg;                     //Full: let the ISR make room.
+    }
+}
+
+void EEQueue::write( uint16_t addr, const void *buf, uint16_t len ){
+    const uint8_t *ptr = (const uint8_t*) buf;
+    while( len-- ) write( addr++, *ptr++ );
+}
+
+void EEQueue::writeBlock( uint16_t addr, const void *buf, uint16_t len ){
+    for(;;){
+        uint8_t sreg = SREG;
+        cli();
+
+        if( bPos < bLen && ( addr != bAddr || buf != bSrc || len != bLen ) ){
+            SREG = sreg;                 //Another object is still being programmed.
+            continue;
+        }
+        bSrc = (const uint8_t*) buf;
+        bAddr = addr;
+        bLen = len;
+        bPos = 0;
+        bMark = qHead;
+        EECR |= _BV( EERIE );
+        SREG = sreg;
+        return;
+    }
+}
+
+uint8_t EEQueue::read( uint16_t addr ){
+    uint8_t sreg = SREG;
+    uint8_t val;
+
+    for(;;){
+        cli();
+
+        //The newest queued value wins: search back from qHead, the object sits at bMark.
+        bool inBlock = bPos < bLen && addr >= bAddr && addr - bAddr < bLen;
+        for( uint8_t i = qHead ; ; ){
+            if( inBlock && i == bMark ){
+                val = bSrc[ addr - bAddr ];
+                SREG = sreg;
+                return val;
+            }
+            if( i == qTail ) break;
+            i = ( i - 1 ) & QUEUE_MASK;
+            if( qAddr[ i ] == addr ){
+                val = qData[ i ];
+                SREG = sreg;
+                return val;
+            }
+        }
+        if( !( EECR & _BV( EEPE ) ) ) break;
+        SREG = sreg;                     //EEAR is locked while programming.
+    }
+
+    EEAR = addr;
+    EECR |= _BV( EERE );
+    val = EEDR;
+    SREG = sreg;
+    return val;
+}
+
+void EEQueue::read( uint16_t addr, void *buf, uint16_t len ){
+    uint8_t *ptr = (uint8_t*) buf;
+    while( len-- ) *ptr++ = read( addr++ );
+}
+
+bool EEQueue::busy(){
+    return EECR & _BV( EERIE );
+}
+
+void EEQueue::flush(){
+    while( busy() );
+}
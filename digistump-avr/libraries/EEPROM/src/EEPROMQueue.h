@@ -0,0 +1,95 @@
+/*
+  EEPROMQueue.h - interrupt driven EEPROM write queue
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef EEPROMQueue_h
+#define EEPROMQueue_h
+
+#include <inttypes.h>
+#include <avr/io.h>
+
+//Number of bytes that can wait to be programmed, must be a power of two.
+//Each entry costs 3 bytes of RAM.
+#ifndef EEPROM_QUEUE_SIZE
+#define EEPROM_QUEUE_SIZE 16
+#endif
+
+#if (EEPROM_QUEUE_SIZE & (EEPROM_QUEUE_SIZE - 1)) || (EEPROM_QUEUE_SIZE > 128)
+#error EEPROM_QUEUE_SIZE must be a power of two, 128 at most
+#endif
+
+/***
+    Program one byte. Must be called with interrupts disabled and no programming in
+    progress (EEPE clear). The shortest programming mode the bits allow is used: erase
+    only (to 0xFF) or write only (bits are only cleared) take 1.8 ms, erase and write
+    3.4 ms. Returns false, and programs nothing, if the cell already holds 'val'.
+***/
+
+static inline bool eeprom_program( uint16_t addr, uint8_t val ){
+    uint8_t old, mode;
+
+    EEAR = addr;
+    EECR |= _BV( EERE );
+    old = EEDR;
+    if( old == val ) return false;
+
+    if( val == 0xFF ) mode = _BV( EEPM0 );                 //Erase only.
+    else if( ( old & val ) == val ) mode = _BV( EEPM1 );   //Write only.
+    else mode = 0;                                         //Erase and write.
+
+    EEDR = val;
+    EECR = ( EECR & _BV( EERIE ) ) | mode | _BV( EEMPE );
+    EECR |= _BV( EEPE );                 //Must follow EEMPE within 4 cycles.
+    return true;
+}
+
+/***
+    EEQueue class.
+
+    Bytes are queued in RAM and programmed one after the other from the EE_READY
+    interrupt, so a write costs a few microseconds instead of a 3.4 ms busy wait.
+    Bytes already holding the right value are skipped (update semantics) and a byte
+    queued again before it was programmed only replaces the queued value.
+
+    While the queue is in use, read EEPROM through EEQueue::read(): it returns the
+    queued value of bytes not yet programmed and never touches EEAR while the
+    interrupt is programming a byte.
+
+    writeBlock() queues a whole object without copying it: its bytes are taken from
+    RAM when they are programmed, so it must stay valid until busy() is false.  Queuing
+    the same object again while it is being programmed restarts it, so later changes
+    are written too.  Only one object can wait at a time.  Single bytes and objects are
+    programmed in the order they were queued, so the newest value of a byte always ends
+    up in the EEPROM.
+
+    write() and writeBlock() only wait if there is no room, so they must not be called
+    with interrupts disabled then.
+***/
+
+struct EEQueue{
+
+    static void write( uint16_t addr, uint8_t val );
+    static void write( uint16_t addr, const void *buf, uint16_t len );
+    static void writeBlock( uint16_t addr, const void *buf, uint16_t len );
+    static uint8_t read( uint16_t addr );
+    static void read( uint16_t addr, void *buf, uint16_t len );
+
+    static bool busy();                  //True until the last queued byte is programmed.
+    static void flush();                 //Wait until !busy().
+};
+
+#endif
@@ -0,0 +1,157 @@
+/*
+  EEPROMStore.cpp - wear levelled record store on top of EEQueue
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <util/crc16.h>
+#include "EEPROMStore.h"
+
+#define NO_RECORD   0xFF
+#define NO_KEY      0xFF                 //Key byte of an erased record.
+
+EEStore::EEStore( uint16_t start, uint16_t size, uint8_t valueSize )
+    : base( start ), length( valueSize ), head( 0 ), seq( 0 )
+{
+    uint16_t n = size / ( valueSize + 3 );
+    count = n > 255 ? 255 : n;           //Less than 256 keeps the sequence gap unique.
+}
+
+/***
+    A record is valid if it has a key and its CRC matches.
+***/
+
+bool EEStore::valid( uint8_t rec ){
+    uint16_t a = addr( rec );
+    uint8_t crc = 0;
+
+    if( EEQueue::read( a + 1 ) == NO_KEY ) return false;
+    for( uint8_t i = length + 2 ; i ; --i ) crc = _crc_ibutton_update( crc, EEQueue::read( a++ ) );
+    return crc == EEQueue::read( a );
+}
+
+/***
+    The newest valid record of 'k', found by walking back from the head.
+***/
+
+uint8_t EEStore::newest( uint8_t k ){
+    uint8_t rec = head;
+
+    for( uint8_t n = count ; n ; --n ){
+        rec = rec ? rec - 1 : count - 1;
+        if( key( rec ) == k && valid( rec ) ) return rec;
+    }
+    return NO_RECORD;
+}
+
+bool EEStore::live( uint8_t rec ){
+    uint8_t k = key( rec );
+    return k != NO_KEY && newest( k ) == rec;
+}
+
+/***
+    Write a record at the head, the value comes from record 'src' (a copy) or
+    from 'value', zero padded to the record length.
+***/
+
+void EEStore::append( uint8_t k, uint8_t src, const uint8_t *value, uint8_t len ){
+    uint16_t a = addr( head );
+    uint16_t s = src != NO_RECORD ? addr( src ) + 2 : 0;
+    uint8_t crc = 0;
+    uint8_t b;
+
+    crc = _crc_ibutton_update( crc, seq );
+    EEQueue::write( a++, seq );
+    crc = _crc_ibutton_update( crc, k );
+    EEQueue::write( a++, k );
+    for( uint8_t i = 0 ; i < length ; ++i ){
+        if( src != NO_RECORD ) b = EEQueue::read( s++ );
+        else b = i < len ? value[ i ] : 0;
+        crc = _crc_ibutton_update( crc, b );
+        EEQueue::write( a++, b );
+    }
+    EEQueue::write( a, crc );
+
+    head = next( head );
+    ++seq;
+}
+
+/***
+    The head is the record after the one whose successor breaks the sequence.
+***/
+
+void EEStore::begin(){
+    head = 0;
+    seq = 0;
+    for( uint8_t rec = 0 ; rec < count ; ++rec ){
+        if( !valid( rec ) ) continue;
+        uint8_t s = EEQueue::read( addr( rec ) );
+        uint8_t n = next( rec );
+        if( !valid( n ) || EEQueue::read( addr( n ) ) != (uint8_t)( s + 1 ) ){
+            head = n;
+            seq = s + 1;
+            return;
+        }
+    }
+}
+
+void EEStore::format(){
+    for( uint8_t rec = 0 ; rec < count ; ++rec ) EEQueue::write( addr( rec ) + 1, NO_KEY );
+    head = 0;
+    seq = 0;
+}
+
+bool EEStore::get( uint8_t k, void *value, uint8_t len ){
+    uint8_t rec = newest( k );
+
+    if( rec == NO_RECORD ) return false;
+    EEQueue::read( addr( rec ) + 2, value, len < length ? len : length );
+    return true;
+}
+
+uint8_t EEStore::put( uint8_t k, const void *value, uint8_t len ){
+    const uint8_t *v = (const uint8_t*) value;
+    uint8_t rec;
+
+    if( k == NO_KEY || len > length || count < 2 ) return EESTORE_INVALID;
+
+    rec = newest( k );
+    if( rec != NO_RECORD ){
+        //Update semantics on the whole record.
+        uint16_t a = addr( rec ) + 2;
+        uint8_t i;
+        for( i = 0 ; i < length ; ++i ){
+            if( EEQueue::read( a + i ) != ( i < len ? v[ i ] : 0 ) ) break;
+        }
+        if( i == length ) return EESTORE_UNCHANGED;
+    }else{
+        //A new key needs a dead record somewhere ahead of the head.
+        uint8_t l = next( head );
+        uint8_t n;
+        for( n = count - 1 ; n ; --n, l = next( l ) ){
+            if( !live( l ) ) break;
+        }
+        if( !n ) return EESTORE_FULL;
+    }
+
+    //Copy forward the records that would otherwise lose their last copy.
+    for(;;){
+        uint8_t l = next( head );
+        if( !live( l ) || key( l ) == k ) break;
+        append( key( l ), l, 0, 0 );
+    }
+    append( k, NO_RECORD, v, len );
+    return EESTORE_WRITTEN;
+}
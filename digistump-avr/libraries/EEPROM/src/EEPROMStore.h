@@ -0,0 +1,87 @@
+/*
+  EEPROMStore.h - wear levelled record store on top of EEQueue
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef EEPROMStore_h
+#define EEPROMStore_h
+
+#include <inttypes.h>
+#include "EEPROMQueue.h"
+
+//Results of EEStore::put().
+#define EESTORE_WRITTEN     0   //A new record was queued.
+#define EESTORE_UNCHANGED   1   //The stored value is already the same, nothing written.
+#define EESTORE_FULL        2   //New key, but no room left for it.
+#define EESTORE_INVALID     3   //Key 0xFF or value too long.
+
+/***
+    EEStore class.
+
+    A log of fixed size records in the EEPROM area [start, start + size).
+    Each record is: sequence number, key, value (valueSize bytes), CRC-8.
+
+    Records are written round-robin, a key is never rewritten in place, so every
+    cell of the area is programmed once per turn of the log instead of once per
+    write: a 512 byte area with 4 byte values holds 73 records, so a counter in it
+    lasts 73 times longer than in a fixed cell.  The newest valid record of a key
+    holds its value; a record torn by a reset fails its CRC and the previous one
+    is used.
+
+    The log position after the newest record is always a dead record (empty, or
+    superseded by a newer one).  When the next position holds the only record of
+    another key, that record is copied forward first, so a write never destroys
+    the last copy of any key.  At most (records - 1) distinct keys can be stored.
+
+    Writes go through EEQueue, so put() returns after a few microseconds (unless a
+    record does not fit the queue, see EEPROM_QUEUE_SIZE); a value equal to the
+    stored one is not written at all.
+***/
+
+struct EEStore{
+
+    EEStore( uint16_t start, uint16_t size, uint8_t valueSize );
+
+    void begin();                        //Find the end of the log, call once at startup.
+    void format();                       //Forget all keys.
+
+    uint8_t put( uint8_t key, const void *value, uint8_t len );
+    bool get( uint8_t key, void *value, uint8_t len );
+
+    template< typename T > uint8_t put( uint8_t key, const T &t ){ return put( key, &t, sizeof(T) ); }
+    template< typename T > bool get( uint8_t key, T &t ){ return get( key, &t, sizeof(T) ); }
+
+    uint8_t records()                    { return count; }
+    bool busy()                          { return EEQueue::busy(); }
+    void flush()                         { EEQueue::flush(); }
+
+  private:
+    uint16_t base;
+    uint8_t  count;                      //Number of records in the area.
+    uint8_t  length;                     //Value length.
+    uint8_t  head;                       //Record written next.
+    uint8_t  seq;                        //Sequence number of the record written next.
+
+    uint16_t addr( uint8_t rec )         { return base + (uint16_t) rec * ( length + 3 ); }
+    uint8_t next( uint8_t rec )          { return rec + 1 < count ? rec + 1 : 0; }
+    uint8_t key( uint8_t rec )           { return EEQueue::read( addr( rec ) + 1 ); }
+    bool valid( uint8_t rec );
+    bool live( uint8_t rec );
+    uint8_t newest( uint8_t key );
+    void append( uint8_t key, uint8_t src, const uint8_t *value, uint8_t len );
+};
+
+#endif
@@ -25,21 +25,77 @@ void ArduinoNunchuk::init()
   ArduinoNunchuk::_sendByte(0x55, 0xF0);
   ArduinoNunchuk::_sendByte(0x00, 0xFB);
 
+  ArduinoNunchuk::_request();
+  delayMicroseconds(NUNCHUK_CONVERSION_US);
   ArduinoNunchuk::update();
 }
 
-void ArduinoNunchuk::update()
+/*
+ * The conversion of the next values is requested right after each read, so
+ * they are ready on the following call instead of waiting for them here.
+ */
+boolean ArduinoNunchuk::update()
 {
-  int count = 0;
-  int values[6];
+  if ((micros() - _requestUs) < NUNCHUK_CONVERSION_US)
+  {
+    return false;
+  }
 
-  TinyWireM.requestFrom(ADDRESS, 6);
+  boolean ok = ArduinoNunchuk::_read();
+
+  ArduinoNunchuk::_request();
+  if (ok)
+  {
+    ArduinoNunchuk::_decode();
+  }
+  return ok;
+}
+
+/*
+ * For a reader on a fixed schedule (e.g. DigiJoystick.bridge()): the values
+ * are converted now, not at the previous call.
+ */
+boolean ArduinoNunchuk::readNow()
+{
+  ArduinoNunchuk::_request();
+  delayMicroseconds(NUNCHUK_CONVERSION_US);
+
+  boolean ok = ArduinoNunchuk::_read();
+
+  ArduinoNunchuk::_request();
+  if (ok)
+  {
+    ArduinoNunchuk::_decode();
+  }
+  return ok;
+}
 
-  while(TinyWireM.available())
+boolean ArduinoNunchuk::_read()
+{
+  // Bus error: the previous values are kept
+  if (TinyWireM.requestFrom(ADDRESS, 6))
+  {
+    return false;
+  }
+  for (byte i = 0; i < 6; i++)
   {
-    values[count] = TinyWireM.receive();
-    count++;
+    _raw[i] = TinyWireM.receive();
   }
+  return true;
+}
+
+void ArduinoNunchuk::_request()
+{
+  TinyWireM.beginTransmission(ADDRESS);
+  TinyWireM.send(0x00);
+  TinyWireM.endTransmission();
+
+  _requestUs = micros();
+}
+
+void ArduinoNunchuk::_decode()
+{
+  byte *values = _raw;
 
   ArduinoNunchuk::analogX = values[0];
   ArduinoNunchuk::analogY = values[1];
@@ -48,8 +104,6 @@ void ArduinoNunchuk::update()
   ArduinoNunchuk::accelZ = (values[4] << 2) | ((values[5] >> 6) & 3);
   ArduinoNunchuk::zButton = !((values[5] >> 0) & 1);
   ArduinoNunchuk::cButton = !((values[5] >> 1) & 1);
-
-  ArduinoNunchuk::_sendByte(0x00, 0x00);
 }
 
 void ArduinoNunchuk::_sendByte(byte data, byte location)
@@ -17,6 +17,9 @@
 
 #include <Arduino.h>
 
+// Time the controller needs between the conversion request and the read of its result
+#define NUNCHUK_CONVERSION_US 1000
+
 class ArduinoNunchuk
 {
   public:
@@ -29,10 +32,17 @@ class ArduinoNunchuk
     int cButton;
 
     void init();
-    void update();
+    boolean update(); // Never waits: true if new values were read
+    boolean readNow(); // Fresh values: waits for a conversion (about 1.7 ms)
 
   private:
+    byte _raw[6];
+    unsigned long _requestUs;
+
     void _sendByte(byte data, byte location);
+    void _request();
+    boolean _read();
+    void _decode();
 };
 
 #endif
@@ -4,25 +4,37 @@
 #include <ArduinoNunchuk.h>
 #include <TinyWireM.h>
 
+// buildReport() fills the default report layout of usbconfig.h:
+// 6 axes of 8 bits and 16 buttons, 8 bytes
+#if DIGIJOYSTICK_AXES != 6 || DIGIJOYSTICK_AXIS_BITS != 8 || DIGIJOYSTICK_HAT || DIGIJOYSTICK_BUTTONS != 16
+#error "This example needs the default DigiJoystick report layout"
+#endif
+
 ArduinoNunchuk nunchuk = ArduinoNunchuk();
 
+// Called by DigiJoystick right before the host polls the joystick:
+// the report sent is read from the nunchuk at that time.
+void buildReport(unsigned char *report) {
+  nunchuk.readNow();
+  report[0] = (byte) nunchuk.analogX; // X
+  report[1] = (byte) nunchuk.analogY; // Y
+  report[2] = (byte) map(nunchuk.accelX,255,700,0,255); // XROT
+  report[3] = (byte) map(nunchuk.accelY,255,850,0,255); // YROT
+  report[4] = (byte) map(nunchuk.accelZ,255,750,0,255); // ZROT
+  report[5] = 0; // SLIDER
+  int buttonByte = 0;
+  bitWrite(buttonByte, 0, nunchuk.zButton);
+  bitWrite(buttonByte, 1, nunchuk.cButton);
+  report[6] = (byte) buttonByte;
+  report[7] = 0;
+}
+
 void setup() {
   nunchuk.init();
+  DigiJoystick.bridge(buildReport);
 }
 
 
 void loop() {
-  nunchuk.update();
-  DigiJoystick.setX((byte) nunchuk.analogX); // scroll X left to right repeatedly
-  DigiJoystick.setY((byte) nunchuk.analogY);
-  DigiJoystick.setXROT((byte) map(nunchuk.accelX,255,700,0,255));
-  DigiJoystick.setYROT((byte) map(nunchuk.accelY,255,850,0,255));
-  DigiJoystick.setZROT((byte) map(nunchuk.accelZ,255,750,0,255));
-  int buttonByte = 0;
-  bitWrite(buttonByte, 0, nunchuk.zButton);
-  bitWrite(buttonByte, 1, nunchuk.cButton);
-  DigiJoystick.setButtons((byte) buttonByte, (byte) 0);
-  DigiJoystick.delay(10); 
-  
-  
-}
\ No newline at end of file
+  DigiJoystick.update();
+}
@@ -116,12 +116,18 @@ sample code bearing this copyright.
 
 #include "OneWire.h"
 
+#if ONEWIRE_OVERDRIVE
+#include <util/delay.h>
+#endif
 
 OneWire::OneWire(uint8_t pin)
 {
 	pinMode(pin, INPUT);
 	bitmask = PIN_TO_BITMASK(pin);
 	baseReg = PIN_TO_BASEREG(pin);
+#if ONEWIRE_OVERDRIVE
+	overdrive = 0;
+#endif
 #if ONEWIRE_SEARCH
 	reset_search();
 #endif
@@ -150,6 +156,23 @@ uint8_t OneWire::reset(void)
 		delayMicroseconds(2);
 	} while ( !DIRECT_READ(reg, mask));
 
+#if ONEWIRE_OVERDRIVE
+	if (overdrive) {
+		// Overdrive reset: 70uS low, sample at 8.5uS, 40uS recovery.
+		// Short enough to keep interrupts off for the whole pulse.
+		noInterrupts();
+		DIRECT_WRITE_LOW(reg, mask);
+		DIRECT_MODE_OUTPUT(reg, mask);	// drive output low
+		_delay_us(70);
+		DIRECT_MODE_INPUT(reg, mask);	// allow it to float
+		_delay_us(8.5);
+		r = !DIRECT_READ(reg, mask);
+		interrupts();
+		_delay_us(40);
+		return r;
+	}
+#endif
+
 	noInterrupts();
 	DIRECT_WRITE_LOW(reg, mask);
 	DIRECT_MODE_OUTPUT(reg, mask);	// drive output low
@@ -173,6 +196,26 @@ void OneWire::write_bit(uint8_t v)
 	IO_REG_TYPE mask=bitmask;
 	volatile IO_REG_TYPE *reg IO_REG_ASM = baseReg;
 
+#if ONEWIRE_OVERDRIVE
+	if (overdrive) {
+		noInterrupts();
+		DIRECT_WRITE_LOW(reg, mask);
+		DIRECT_MODE_OUTPUT(reg, mask);	// drive output low
+		if (v & 1) {
+			_delay_us(1);
+			DIRECT_WRITE_HIGH(reg, mask);	// drive output high
+			interrupts();
+			_delay_us(7.5);
+		} else {
+			_delay_us(7.5);
+			DIRECT_WRITE_HIGH(reg, mask);	// drive output high
+			interrupts();
+			_delay_us(2.5);
+		}
+		return;
+	}
+#endif
+
 	if (v & 1) {
 		noInterrupts();
 		DIRECT_WRITE_LOW(reg, mask);
@@ -202,6 +245,21 @@ uint8_t OneWire::read_bit(void)
 	volatile IO_REG_TYPE *reg IO_REG_ASM = baseReg;
 	uint8_t r;
 
+#if ONEWIRE_OVERDRIVE
+	if (overdrive) {
+		noInterrupts();
+		DIRECT_MODE_OUTPUT(reg, mask);
+		DIRECT_WRITE_LOW(reg, mask);
+		_delay_us(1);
+		DIRECT_MODE_INPUT(reg, mask);	// let pin float, pull up will raise
+		_delay_us(1);
+		r = DIRECT_READ(reg, mask);
+		interrupts();
+		_delay_us(7);
+		return r;
+	}
+#endif
+
 	noInterrupts();
 	DIRECT_MODE_OUTPUT(reg, mask);
 	DIRECT_WRITE_LOW(reg, mask);
@@ -291,6 +349,39 @@ void OneWire::depower()
 	interrupts();
 }
 
+#if ONEWIRE_OVERDRIVE
+
+//
+// Do an overdrive ROM skip, every overdrive capable device switches
+//
+void OneWire::overdrive_skip()
+{
+    overdrive = 0;
+    write(0x3C);           // Overdrive Skip ROM
+    overdrive = 1;
+}
+
+//
+// Do an overdrive ROM select, only the matching device switches
+//
+void OneWire::overdrive_select(const uint8_t rom[8])
+{
+    uint8_t i;
+
+    overdrive = 0;
+    write(0x69);           // Overdrive Match ROM
+    overdrive = 1;
+
+    for (i = 0; i < 8; i++) write(rom[i]);
+}
+
+void OneWire::set_overdrive(bool enable)
+{
+    overdrive = enable;
+}
+
+#endif
+
 #if ONEWIRE_SEARCH
 
 //
@@ -339,7 +430,7 @@ void OneWire::target_search(uint8_t family_code)
 // Return TRUE  : device found, ROM number in ROM_NO buffer
 //        FALSE : device not found, end of search
 //
-uint8_t OneWire::search(uint8_t *newAddr)
+uint8_t OneWire::search(uint8_t *newAddr, bool search_mode /* = true */)
 {
    uint8_t id_bit_number;
    uint8_t last_zero, rom_byte_number, search_result;
@@ -368,7 +459,11 @@ uint8_t OneWire::search(uint8_t *newAddr)
       }
 
       // issue the search command
-      write(0xF0);
+      if (search_mode == true) {
+        write(0xF0);   // NORMAL SEARCH
+      } else {
+        write(0xEC);   // CONDITIONAL SEARCH
+      }
 
       // loop to do the search
       do
@@ -457,6 +552,48 @@ uint8_t OneWire::search(uint8_t *newAddr)
    return search_result;
   }
 
+//
+// Verify the device with the ROM number 'rom' is present, see Maxim
+// Application Note 187.  The search state is saved and restored.
+//
+uint8_t OneWire::verify(const uint8_t rom[8])
+{
+   unsigned char rom_backup[8];
+   uint8_t found[8];
+   uint8_t i, result;
+   uint8_t ld_backup, ldf_backup, lfd_backup;
+
+   // keep a backup copy of the current state
+   for (i = 0; i < 8; i++) rom_backup[i] = ROM_NO[i];
+   ld_backup = LastDiscrepancy;
+   ldf_backup = LastDeviceFlag;
+   lfd_backup = LastFamilyDiscrepancy;
+
+   // set search to find the same device
+   for (i = 0; i < 8; i++) ROM_NO[i] = rom[i];
+   LastDiscrepancy = 64;
+   LastDeviceFlag = FALSE;
+
+   result = search(found);
+   if (result) {
+      // check if same device found
+      for (i = 0; i < 8; i++) {
+         if (found[i] != rom[i]) {
+            result = FALSE;
+            break;
+         }
+      }
+   }
+
+   // restore the search state
+   for (i = 0; i < 8; i++) ROM_NO[i] = rom_backup[i];
+   LastDiscrepancy = ld_backup;
+   LastDeviceFlag = ldf_backup;
+   LastFamilyDiscrepancy = lfd_backup;
+
+   return result;
+}
+
 #endif
 
 #if ONEWIRE_CRC
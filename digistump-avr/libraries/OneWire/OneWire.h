@@ -45,6 +45,29 @@
 #define ONEWIRE_CRC16 1
 #endif
 
+// Overdrive speed (about 8 times faster time slots) is supported on AVR
+// by defining this to 1.  The overdrive slots are timed with _delay_us()
+// because delayMicroseconds() is not accurate enough below 10uS.
+#ifndef ONEWIRE_OVERDRIVE
+#if defined(__AVR__)
+#define ONEWIRE_OVERDRIVE 1
+#else
+#define ONEWIRE_OVERDRIVE 0
+#endif
+#endif
+
+// The interrupt driven transaction engine in OneWireAsync.h is built
+// when this is 1.  The library is linked as an archive (dot_a_linkage in
+// library.properties), so the engine and its timer compare interrupt
+// vector only end up in sketches that use OneWireAsync.
+#ifndef ONEWIRE_ASYNC
+#if defined(__AVR__)
+#define ONEWIRE_ASYNC 1
+#else
+#define ONEWIRE_ASYNC 0
+#endif
+#endif
+
 #define FALSE 0
 #define TRUE  1
 
@@ -123,6 +146,10 @@ class OneWire
     uint8_t LastDeviceFlag;
 #endif
 
+#if ONEWIRE_OVERDRIVE
+    uint8_t overdrive;
+#endif
+
   public:
     OneWire( uint8_t pin);
 
@@ -164,6 +191,26 @@ class OneWire
     // someone shorts your bus.
     void depower(void);
 
+#if ONEWIRE_OVERDRIVE
+    // Issue a 1-Wire overdrive skip command (at standard speed), then
+    // switch to overdrive speed.  All overdrive capable devices on the
+    // bus follow, so only use this if every device supports overdrive.
+    void overdrive_skip(void);
+
+    // Issue a 1-Wire overdrive match command for a single device, you
+    // do the (standard speed) reset first.  The rom is sent at overdrive
+    // speed and the bus stays in overdrive speed afterwards.
+    void overdrive_select(const uint8_t rom[8]);
+
+    // Select the speed used by reset(), read_bit() and write_bit().
+    // A reset at standard speed returns all devices to standard speed,
+    // so set_overdrive(false) followed by reset() leaves overdrive.
+    void set_overdrive(bool enable);
+
+    // Returns true if the bus is currently driven at overdrive speed.
+    bool is_overdrive(void) { return overdrive; }
+#endif
+
 #if ONEWIRE_SEARCH
     // Clear the search state so that if will start from the beginning again.
     void reset_search();
@@ -178,7 +225,14 @@ class OneWire
     // might be a good idea to check the CRC to make sure you didn't
     // get garbage.  The order is deterministic. You will always get
     // the same devices in the same order.
-    uint8_t search(uint8_t *newAddr);
+    // If 'search_mode' is false, the alarm search command is used and
+    // only devices with an alarm condition are returned.
+    uint8_t search(uint8_t *newAddr, bool search_mode = true);
+
+    // Check that the device with this ROM is still on the bus.  This
+    // walks the search tree along that ROM only (one reset and 64 search
+    // steps) and does not disturb a search in progress.
+    uint8_t verify(const uint8_t rom[8]);
 #endif
 
 #if ONEWIRE_CRC
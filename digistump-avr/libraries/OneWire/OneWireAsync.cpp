@@ -0,0 +1,211 @@
+/*
+Interrupt driven 1-Wire transaction engine, see OneWireAsync.h.
+
+The timing follows Maxim Application Note 126 (standard speed):
+  reset:   480uS low, sample presence 70uS after release, 410uS recovery
+  write 1: 6uS low, 64uS high
+  write 0: 60uS low, 10uS high
+  read:    3uS low, sample 10uS after release, 53uS high
+
+Each time slot is started by a compare match interrupt.  Everything up to
+and including the sample point is done with interrupts disabled (inside
+the ISR), the rest of the slot is left to the timer, so the main loop and
+other interrupts (V-USB) run in between the slots.
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "OneWireAsync.h"
+
+#if ONEWIRE_ASYNC
+
+#include <util/delay.h>
+
+// microseconds to timer ticks, rounded up, never less than 2 ticks so the
+// compare match can not be missed
+#define OW_CYCLES(us) ((us) * (F_CPU / 1000L) / 1000L)
+#define OW_TICKS_RAW(us) \
+	((OW_CYCLES(us) + ONEWIRE_ASYNC_TIMER_PRESCALER - 1) / ONEWIRE_ASYNC_TIMER_PRESCALER)
+#define OW_TICKS(us) (OW_TICKS_RAW(us) < 2 ? 2 : OW_TICKS_RAW(us))
+
+enum {
+	OW_IDLE = 0,
+	OW_RESET_RELEASE,
+	OW_RESET_SAMPLE,
+	OW_SLOT,
+	OW_SLOT_RELEASE
+};
+
+// engine state, shared with the ISR
+static volatile uint8_t state = OW_IDLE;
+static uint8_t presence_r;
+static IO_REG_TYPE mask;
+static volatile IO_REG_TYPE *reg;
+static const uint8_t *tx;
+static uint8_t *rx;
+static uint8_t txLeft;
+static uint8_t rxLeft;
+static uint8_t bitMask;
+static uint8_t keepPower;
+
+static inline void alarm(uint8_t ticks)
+{
+	ONEWIRE_ASYNC_OCR = (uint8_t)(ONEWIRE_ASYNC_TCNT + ticks);
+}
+
+static inline void finish(void)
+{
+	ONEWIRE_ASYNC_TIMSK &= ~_BV(ONEWIRE_ASYNC_OCIE);
+	if (!keepPower) {
+		DIRECT_MODE_INPUT(reg, mask);
+		DIRECT_WRITE_LOW(reg, mask);
+	}
+	state = OW_IDLE;
+}
+
+OneWireAsync::OneWireAsync(uint8_t pin)
+{
+	pinMode(pin, INPUT);
+	bitmask = PIN_TO_BITMASK(pin);
+	baseReg = PIN_TO_BASEREG(pin);
+}
+
+uint8_t OneWireAsync::start(const uint8_t *txBuf, uint8_t txCount,
+                            uint8_t *rxBuf, uint8_t rxCount,
+                            bool withReset, bool power)
+{
+	if (state != OW_IDLE) return 0;
+
+	mask = bitmask;
+	reg = baseReg;
+	tx = txBuf;
+	rx = rxBuf;
+	txLeft = txCount;
+	rxLeft = rxCount;
+	bitMask = 0x01;
+	keepPower = power;
+	presence_r = 0;
+
+	noInterrupts();
+	if (withReset) {
+		DIRECT_WRITE_LOW(reg, mask);
+		DIRECT_MODE_OUTPUT(reg, mask);	// drive output low
+		alarm(OW_TICKS(480));
+		state = OW_RESET_RELEASE;
+	} else {
+		alarm(2);
+		state = OW_SLOT;
+	}
+	ONEWIRE_ASYNC_TIFR = _BV(ONEWIRE_ASYNC_OCF);	// discard a stale match
+	ONEWIRE_ASYNC_TIMSK |= _BV(ONEWIRE_ASYNC_OCIE);
+	interrupts();
+	return 1;
+}
+
+uint8_t OneWireAsync::busy(void)
+{
+	return state != OW_IDLE;
+}
+
+uint8_t OneWireAsync::presence(void)
+{
+	return presence_r;
+}
+
+void OneWireAsync::abort(void)
+{
+	noInterrupts();
+	if (state != OW_IDLE) {
+		keepPower = 0;
+		finish();
+	}
+	interrupts();
+}
+
+ISR(ONEWIRE_ASYNC_vect)
+{
+	switch (state) {
+	case OW_RESET_RELEASE:
+		DIRECT_MODE_INPUT(reg, mask);	// allow it to float
+		alarm(OW_TICKS(70));
+		state = OW_RESET_SAMPLE;
+		break;
+
+	case OW_RESET_SAMPLE:
+		presence_r = !DIRECT_READ(reg, mask);
+		if (!presence_r) {
+			finish();
+			break;
+		}
+		alarm(OW_TICKS(410));
+		state = OW_SLOT;
+		break;
+
+	case OW_SLOT:
+		if (txLeft) {
+			DIRECT_WRITE_LOW(reg, mask);
+			DIRECT_MODE_OUTPUT(reg, mask);	// drive output low
+			if (*tx & bitMask) {
+				_delay_us(6);
+				DIRECT_WRITE_HIGH(reg, mask);	// drive output high
+				alarm(OW_TICKS(64));
+			} else {
+				alarm(OW_TICKS(60));
+				state = OW_SLOT_RELEASE;
+			}
+			bitMask <<= 1;
+			if (!bitMask) {
+				bitMask = 0x01;
+				tx++;
+				txLeft--;
+			}
+		} else if (rxLeft) {
+			DIRECT_MODE_OUTPUT(reg, mask);
+			DIRECT_WRITE_LOW(reg, mask);
+			_delay_us(3);
+			DIRECT_MODE_INPUT(reg, mask);	// let pin float, pull up will raise
+			_delay_us(10);
+			if (DIRECT_READ(reg, mask)) *rx |= bitMask;
+			else *rx &= ~bitMask;
+			alarm(OW_TICKS(53));
+			bitMask <<= 1;
+			if (!bitMask) {
+				bitMask = 0x01;
+				rx++;
+				rxLeft--;
+			}
+		} else {
+			finish();
+		}
+		break;
+
+	case OW_SLOT_RELEASE:
+		DIRECT_WRITE_HIGH(reg, mask);	// drive output high
+		alarm(OW_TICKS(10));
+		state = OW_SLOT;
+		break;
+
+	default:
+		finish();
+		break;
+	}
+}
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef OneWireAsync_h
+#define OneWireAsync_h
+
+#include "OneWire.h"
+
+// Pick the timer compare unit used as a one-shot alarm.  The counter of
+// the millis() timer is only read, never written, so millis() and
+// micros() stay correct.  The compare register is borrowed, which means
+// hardware PWM on the matching pin is not available while a transaction
+// is running:
+//   ATtiny85 (Timer1 is the millis timer): OCR1B, analogWrite() on pin 4
+//   ATmega (Timer0 is the millis timer): OCR0B, analogWrite() on pin 5
+// The compare A units are left to SoftRcPulseOut.  The ATtiny167 has no
+// other compare unit on its millis timer, so the engine is not available
+// there.
+#if ONEWIRE_ASYNC
+#if defined(TCCR1) && defined(OCR1B) && defined(TIMER_TO_USE_FOR_MILLIS) && (TIMER_TO_USE_FOR_MILLIS == 1)
+#define ONEWIRE_ASYNC_TCNT         TCNT1
+#define ONEWIRE_ASYNC_OCR          OCR1B
+#define ONEWIRE_ASYNC_TIMSK        TIMSK
+#define ONEWIRE_ASYNC_OCIE         OCIE1B
+#define ONEWIRE_ASYNC_TIFR         TIFR
+#define ONEWIRE_ASYNC_OCF          OCF1B
+#define ONEWIRE_ASYNC_vect         TIMER1_COMPB_vect
+#elif defined(OCR0B) && defined(TIMSK0) && !defined(TIMER_TO_USE_FOR_MILLIS)
+#define ONEWIRE_ASYNC_TCNT         TCNT0
+#define ONEWIRE_ASYNC_OCR          OCR0B
+#define ONEWIRE_ASYNC_TIMSK        TIMSK0
+#define ONEWIRE_ASYNC_OCIE         OCIE0B
+#define ONEWIRE_ASYNC_TIFR         TIFR0
+#define ONEWIRE_ASYNC_OCF          OCF0B
+#define ONEWIRE_ASYNC_vect         TIMER0_COMPB_vect
+#else
+#undef ONEWIRE_ASYNC
+#define ONEWIRE_ASYNC 0            // no known free compare unit
+#endif
+#endif
+
+// The slots are scheduled in ticks of the millis() timer.  At 64 cycles
+// per tick that is 4uS at 16MHz, which is fine for standard speed but far
+// too coarse for overdrive, so the engine always runs at standard speed.
+// Keep this in sync with MS_TIMER_TICK_EVERY_X_CYCLES of the core.
+#ifndef ONEWIRE_ASYNC_TIMER_PRESCALER
+#define ONEWIRE_ASYNC_TIMER_PRESCALER 64
+#endif
+
+#if ONEWIRE_ASYNC && (F_CPU < 8000000L)
+#undef ONEWIRE_ASYNC
+#define ONEWIRE_ASYNC 0            // ticks longer than a time slot
+#endif
+
+#if ONEWIRE_ASYNC
+
+// Interrupt driven 1-Wire transactions.  A transaction is an optional
+// reset, followed by 'txCount' bytes written and 'rxCount' bytes read,
+// e.g. a DS18B20 scratchpad readout is { 0x55, rom[0..7], 0xBE } out and
+// 9 bytes in.  start() returns immediately; the bits are clocked by the
+// timer compare interrupt, one time slot per interrupt.  Interrupts are
+// never disabled for more than about 15uS (a read slot), the long low
+// phases of reset and write-0 slots are timed by the compare unit.
+//
+// There is only one engine, so only one transaction (on any pin) can be
+// in progress at a time.  Both buffers must stay valid until busy()
+// returns false.
+class OneWireAsync
+{
+  private:
+    IO_REG_TYPE bitmask;
+    volatile IO_REG_TYPE *baseReg;
+
+  public:
+    OneWireAsync( uint8_t pin);
+
+    // Start a transaction. Returns 0 (and does nothing) if the engine is
+    // still busy with a previous transaction. If 'power' is one then the
+    // wire is held high at the end, see OneWire::write().
+    uint8_t start(const uint8_t *txBuf, uint8_t txCount,
+                  uint8_t *rxBuf = 0, uint8_t rxCount = 0,
+                  bool withReset = true, bool power = false);
+
+    // Returns 1 while a transaction is in progress.
+    static uint8_t busy(void);
+
+    // Returns 1 if a device answered the reset of the last transaction
+    // with a presence pulse.  Only valid once busy() returns 0.
+    static uint8_t presence(void);
+
+    // Stop the transaction in progress and release the bus.
+    static void abort(void);
+};
+
+#endif
+
+#endif
@@ -0,0 +1,208 @@
+/*
+Parallel 1-Wire buses on one port, see OneWirePort.h.
+
+The time slots are the same as the ones of OneWire::reset(), write_bit()
+and read_bit(), the only difference is that the bit mask covers several
+pins: a read samples the whole input register once and the bits are
+sorted per bus after the slot, where the timing is not critical.
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "OneWirePort.h"
+
+#if defined(__AVR__)
+
+// all the bits of 'mask', not just 0 or 1 like DIRECT_READ()
+#define DIRECT_READ_BITS(base, mask)    ((*(base)) & (mask))
+
+
+OneWirePort::OneWirePort(const uint8_t *pins, uint8_t count)
+{
+	uint8_t port = digitalPinToPort(pins[0]);
+
+	bitmask = 0;
+	buses = 0;
+	baseReg = PIN_TO_BASEREG(pins[0]);
+	for (uint8_t i = 0; i < count && buses < ONEWIRE_PORT_MAX_BUSES; i++) {
+		if (digitalPinToPort(pins[i]) != port) continue;
+		pinMode(pins[i], INPUT);
+		busMask[buses++] = PIN_TO_BITMASK(pins[i]);
+		bitmask |= PIN_TO_BITMASK(pins[i]);
+	}
+	active = bitmask;
+}
+
+//
+// Perform the onewire reset function on all buses at once.  Buses that
+// do not come high within 250uS are considered shorted and skipped.
+//
+uint8_t OneWirePort::reset(void)
+{
+	volatile IO_REG_TYPE *reg IO_REG_ASM = baseReg;
+	IO_REG_TYPE mask = bitmask;
+	IO_REG_TYPE r;
+	uint8_t retries = 125;
+	uint8_t present = 0;
+
+	noInterrupts();
+	DIRECT_MODE_INPUT(reg, mask);
+	interrupts();
+	// wait until the wires are high... just in case
+	while (DIRECT_READ_BITS(reg, mask) != mask) {
+		if (--retries == 0) break;
+		delayMicroseconds(2);
+	}
+	mask = DIRECT_READ_BITS(reg, mask);
+	active = 0;
+	if (!mask) return 0;
+
+	noInterrupts();
+	DIRECT_WRITE_LOW(reg, mask);
+	DIRECT_MODE_OUTPUT(reg, mask);	// drive outputs low
+	interrupts();
+	delayMicroseconds(480);
+	noInterrupts();
+	DIRECT_MODE_INPUT(reg, mask);	// allow them to float
+	delayMicroseconds(70);
+	r = ~DIRECT_READ_BITS(reg, mask) & mask;
+	interrupts();
+	active = r;
+	for (uint8_t n = 0; n < buses; n++) {
+		if (r & busMask[n]) present |= (1 << n);
+	}
+	delayMicroseconds(410);
+	return present;
+}
+
+//
+// Write a bit to every active bus: the buses in 'ones' get a 1, the
+// others a 0.  They all start low together, the 1s are released early.
+//
+void OneWirePort::write_bits(IO_REG_TYPE ones)
+{
+	volatile IO_REG_TYPE *reg IO_REG_ASM = baseReg;
+	IO_REG_TYPE mask = active;
+
+	ones &= mask;
+	noInterrupts();
+	DIRECT_WRITE_LOW(reg, mask);
+	DIRECT_MODE_OUTPUT(reg, mask);	// drive outputs low
+	delayMicroseconds(10);
+	DIRECT_WRITE_HIGH(reg, ones);	// drive the 1s high
+	delayMicroseconds(55);
+	DIRECT_WRITE_HIGH(reg, mask);	// drive the 0s high
+	interrupts();
+	delayMicroseconds(5);
+}
+
+//
+// Read a bit from every active bus, returns the raw port bits.
+//
+IO_REG_TYPE OneWirePort::read_bits(void)
+{
+	volatile IO_REG_TYPE *reg IO_REG_ASM = baseReg;
+	IO_REG_TYPE mask = active;
+	IO_REG_TYPE r;
+
+	noInterrupts();
+	DIRECT_MODE_OUTPUT(reg, mask);
+	DIRECT_WRITE_LOW(reg, mask);
+	delayMicroseconds(3);
+	DIRECT_MODE_INPUT(reg, mask);	// let pins float, pull ups will raise
+	delayMicroseconds(10);
+	r = DIRECT_READ_BITS(reg, mask);
+	interrupts();
+	delayMicroseconds(53);
+	return r;
+}
+
+void OneWirePort::write(uint8_t v, uint8_t power /* = 0 */)
+{
+	uint8_t bitMask;
+
+	for (bitMask = 0x01; bitMask; bitMask <<= 1) {
+		write_bits((bitMask & v) ? active : 0);
+	}
+	if (!power) depower();
+}
+
+void OneWirePort::write_each(const uint8_t *v, uint8_t power /* = 0 */)
+{
+	uint8_t bitMask;
+
+	for (bitMask = 0x01; bitMask; bitMask <<= 1) {
+		IO_REG_TYPE ones = 0;
+		for (uint8_t n = 0; n < buses; n++) {
+			if (v[n] & bitMask) ones |= busMask[n];
+		}
+		write_bits(ones);
+	}
+	if (!power) depower();
+}
+
+void OneWirePort::read_bytes(uint8_t *buf, uint8_t count)
+{
+	IO_REG_TYPE raw[8];
+
+	for (uint8_t i = 0; i < count; i++) {
+		for (uint8_t b = 0; b < 8; b++) raw[b] = read_bits();
+		// sort the samples per bus
+		for (uint8_t n = 0; n < buses; n++) {
+			uint8_t r = 0;
+			for (uint8_t b = 0; b < 8; b++) {
+				if (raw[b] & busMask[n]) r |= (1 << b);
+			}
+			buf[n * count + i] = r;
+		}
+	}
+}
+
+//
+// Do a ROM select, every bus gets its own ROM
+//
+void OneWirePort::select(const uint8_t *roms)
+{
+	uint8_t v[ONEWIRE_PORT_MAX_BUSES];
+
+	write(0x55);           // Choose ROM
+	for (uint8_t i = 0; i < 8; i++) {
+		for (uint8_t n = 0; n < buses; n++) v[n] = roms[n * 8 + i];
+		write_each(v);
+	}
+}
+
+//
+// Do a ROM skip on all buses
+//
+void OneWirePort::skip()
+{
+	write(0xCC);           // Skip ROM
+}
+
+void OneWirePort::depower()
+{
+	noInterrupts();
+	DIRECT_MODE_INPUT(baseReg, bitmask);
+	DIRECT_WRITE_LOW(baseReg, bitmask);
+	interrupts();
+}
+
+#endif
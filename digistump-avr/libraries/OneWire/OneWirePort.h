@@ -0,0 +1,65 @@
+#ifndef OneWirePort_h
+#define OneWirePort_h
+
+#include "OneWire.h"
+
+#if defined(__AVR__)
+
+// Maximum number of buses, one per bit of the port
+#define ONEWIRE_PORT_MAX_BUSES 8
+
+// Several 1-Wire buses on pins of the SAME port, driven in parallel.
+// Every time slot is generated for all buses at once, so the same
+// command sequence (e.g. skip + convert) costs the time of one bus, and
+// reads return one byte per bus for the price of one.  Buses are numbered
+// in the order of the pins given to the constructor; pins on another port
+// than the first one are ignored.
+//
+// Data read from several buses is stored bus by bus: with 'count' bytes
+// per bus, bus n gets buf[n * count] .. buf[n * count + count - 1].
+class OneWirePort
+{
+  private:
+    IO_REG_TYPE bitmask;          // all buses
+    IO_REG_TYPE active;           // buses that answered the last reset
+    volatile IO_REG_TYPE *baseReg;
+    uint8_t buses;
+    IO_REG_TYPE busMask[ONEWIRE_PORT_MAX_BUSES];
+
+    IO_REG_TYPE read_bits(void);
+    void write_bits(IO_REG_TYPE ones);
+
+  public:
+    OneWirePort(const uint8_t *pins, uint8_t count);
+
+    // Number of buses handled by this object.
+    uint8_t count(void) { return buses; }
+
+    // Perform a 1-Wire reset cycle on all buses. Returns a bitmap with
+    // bit n set if bus n answered with a presence pulse. Buses without a
+    // device (or shorted) are left alone until the next reset.
+    uint8_t reset(void);
+
+    // Issue a 1-Wire rom skip command on all buses.
+    void skip(void);
+
+    // Issue a 1-Wire rom select command, one rom per bus: bus n selects
+    // roms[n * 8] .. roms[n * 8 + 7].
+    void select(const uint8_t *roms);
+
+    // Write the same byte to all buses. See OneWire::write() for 'power'.
+    void write(uint8_t v, uint8_t power = 0);
+
+    // Write one byte per bus, v[n] goes to bus n.
+    void write_each(const uint8_t *v, uint8_t power = 0);
+
+    // Read 'count' bytes from every bus, stored bus by bus (see above).
+    void read_bytes(uint8_t *buf, uint8_t count);
+
+    // Stop forcing power onto the buses.
+    void depower(void);
+};
+
+#endif
+
+#endif
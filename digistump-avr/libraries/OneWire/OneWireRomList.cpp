@@ -0,0 +1,256 @@
+/*
+Cached list of the ROM numbers of a 1-Wire bus, see OneWireRomList.h.
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "OneWireRomList.h"
+
+#if ONEWIRE_SEARCH
+
+#if defined(__AVR__)
+#include <avr/eeprom.h>
+#endif
+
+// first byte of a saved list
+#define ROM_LIST_MAGIC 0x1E
+
+
+OneWireRomList::OneWireRomList(OneWire &ow, uint8_t (*storage)[8], uint8_t size)
+{
+	bus = &ow;
+	roms = storage;
+	capacity = size < ONEWIRE_ROM_LIST_MAX ? size : ONEWIRE_ROM_LIST_MAX;
+	clear();
+}
+
+void OneWireRomList::clear(void)
+{
+	for (uint8_t i = 0; i < capacity; i++) {
+		for (uint8_t j = 0; j < 8; j++) roms[i][j] = 0;
+	}
+	for (uint8_t i = 0; i < sizeof(misses); i++) misses[i] = 0;
+	checkIdx = 0;
+}
+
+//
+// The device in slot 'idx' answered: its miss count starts over
+//
+void OneWireRomList::found(uint8_t idx)
+{
+	misses[idx >> 2] &= ~(3 << ((idx & 3) * 2));
+}
+
+//
+// The device in slot 'idx' did not answer: count it, and remove it (returns
+// 1) after ONEWIRE_ROM_MISSES misses in a row
+//
+uint8_t OneWireRomList::missed(uint8_t idx)
+{
+	uint8_t shift = (idx & 3) * 2;
+	uint8_t n = ((misses[idx >> 2] >> shift) & 3) + 1;
+
+	if (n < ONEWIRE_ROM_MISSES) {
+		misses[idx >> 2] += 1 << shift;
+		return 0;
+	}
+	found(idx);
+	for (uint8_t j = 0; j < 8; j++) roms[idx][j] = 0;
+	return 1;
+}
+
+uint8_t OneWireRomList::count(void)
+{
+	uint8_t n = 0;
+
+	for (uint8_t i = 0; i < capacity; i++) {
+		if (present(i)) n++;
+	}
+	return n;
+}
+
+int8_t OneWireRomList::find(const uint8_t rom[8])
+{
+	for (uint8_t i = 0; i < capacity; i++) {
+		uint8_t j;
+		for (j = 0; j < 8; j++) {
+			if (roms[i][j] != rom[j]) break;
+		}
+		if (j == 8) return i;
+	}
+	return -1;
+}
+
+//
+// Put a ROM number in the first free slot, returns the slot or 0xFF
+//
+uint8_t OneWireRomList::add(const uint8_t rom[8])
+{
+	for (uint8_t i = 0; i < capacity; i++) {
+		if (!present(i)) {
+			for (uint8_t j = 0; j < 8; j++) roms[i][j] = rom[j];
+			found(i);
+			return i;
+		}
+	}
+	return 0xFF;
+}
+
+uint8_t OneWireRomList::update(void)
+{
+	return update(0);
+}
+
+uint8_t OneWireRomList::update(uint8_t family)
+{
+	uint8_t seen[(ONEWIRE_ROM_LIST_MAX + 7) / 8];
+	uint8_t addr[8];
+	uint8_t result = ONEWIRE_ROM_UNCHANGED;
+	uint8_t full = 0;
+	uint8_t any = 0;
+	int8_t idx;
+
+	for (uint8_t i = 0; i < sizeof(seen); i++) seen[i] = 0;
+
+	// pass 1: mark the known devices, new ones go to the free slots
+	if (family) bus->target_search(family);
+	else bus->reset_search();
+	while (bus->search(addr)) {
+		if (family && addr[0] != family) break;
+#if ONEWIRE_CRC
+		if (OneWire::crc8(addr, 7) != addr[7]) continue;
+#endif
+		any = 1;
+		idx = find(addr);
+		if (idx < 0) {
+			idx = add(addr);
+			if ((uint8_t)idx == 0xFF) {
+				full = 1;
+				continue;
+			}
+			result |= ONEWIRE_ROM_ADDED;
+		}
+		seen[idx >> 3] |= 1 << (idx & 7);
+		found(idx);
+	}
+	bus->reset_search();
+
+	// a failed search (no presence pulse, noise) says nothing about the
+	// devices: only count the misses if something answered
+	if (!any) return full ? result | ONEWIRE_ROM_FULL : result;
+
+	// drop what was not found (of the searched family only) several times
+	for (uint8_t i = 0; i < capacity; i++) {
+		if (!present(i) || (seen[i >> 3] & (1 << (i & 7)))) continue;
+		if (family && roms[i][0] != family) continue;
+		if (missed(i)) result |= ONEWIRE_ROM_REMOVED;
+	}
+
+	// pass 2, only if new devices did not fit: they may fit the slots
+	// freed above now
+	if (full && (result & ONEWIRE_ROM_REMOVED)) {
+		full = 0;
+		if (family) bus->target_search(family);
+		else bus->reset_search();
+		while (bus->search(addr)) {
+			if (family && addr[0] != family) break;
+#if ONEWIRE_CRC
+			if (OneWire::crc8(addr, 7) != addr[7]) continue;
+#endif
+			if (find(addr) >= 0) continue;
+			if (add(addr) == 0xFF) full = 1;
+			else result |= ONEWIRE_ROM_ADDED;
+		}
+		bus->reset_search();
+	}
+	if (full) result |= ONEWIRE_ROM_FULL;
+	return result;
+}
+
+uint8_t OneWireRomList::check(void)
+{
+	for (uint8_t n = 0; n < capacity; n++) {
+		uint8_t i = checkIdx;
+
+		if (++checkIdx >= capacity) checkIdx = 0;
+		if (!present(i)) continue;
+		if (bus->verify(roms[i])) {
+			found(i);
+			return ONEWIRE_ROM_UNCHANGED;
+		}
+		return missed(i) ? ONEWIRE_ROM_REMOVED : ONEWIRE_ROM_UNCHANGED;
+	}
+	return ONEWIRE_ROM_UNCHANGED;
+}
+
+uint8_t OneWireRomList::alarms(void (*handler)(uint8_t idx))
+{
+	uint8_t addr[8];
+	uint8_t n = 0;
+	int8_t idx;
+
+	bus->reset_search();
+	while (bus->search(addr, false)) {
+#if ONEWIRE_CRC
+		if (OneWire::crc8(addr, 7) != addr[7]) continue;
+#endif
+		n++;
+		idx = find(addr);
+		if (idx >= 0 && handler) handler(idx);
+	}
+	bus->reset_search();
+	return n;
+}
+
+#if defined(__AVR__)
+
+void OneWireRomList::save(uint16_t addr)
+{
+	uint8_t *ee = (uint8_t *)addr;
+
+	eeprom_update_byte(ee++, ROM_LIST_MAGIC);
+	eeprom_update_byte(ee++, capacity);
+	for (uint8_t i = 0; i < capacity; i++, ee += 8) {
+		eeprom_update_block(roms[i], ee, 8);
+	}
+}
+
+uint8_t OneWireRomList::load(uint16_t addr)
+{
+	const uint8_t *ee = (const uint8_t *)addr;
+
+	clear();
+	if (eeprom_read_byte(ee++) != ROM_LIST_MAGIC) return 0;
+	if (eeprom_read_byte(ee++) != capacity) return 0;
+	for (uint8_t i = 0; i < capacity; i++, ee += 8) {
+		eeprom_read_block(roms[i], ee, 8);
+#if ONEWIRE_CRC
+		if (present(i) && OneWire::crc8(roms[i], 7) != roms[i][7]) {
+			clear();
+			return 0;
+		}
+#endif
+	}
+	return 1;
+}
+
+#endif
+
+#endif
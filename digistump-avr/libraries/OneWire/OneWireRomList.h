@@ -0,0 +1,114 @@
+#ifndef OneWireRomList_h
+#define OneWireRomList_h
+
+#include "OneWire.h"
+
+#if ONEWIRE_SEARCH
+
+// Results of OneWireRomList::check() and update(), may be or'ed together
+#define ONEWIRE_ROM_UNCHANGED   0x00
+#define ONEWIRE_ROM_REMOVED     0x01   // a known device did not answer
+#define ONEWIRE_ROM_ADDED       0x02   // a new device was found
+#define ONEWIRE_ROM_FULL        0x04   // a new device did not fit the list
+
+// Largest list, a bigger storage is only used up to this many slots.
+// update() keeps one bit per slot on the stack.
+#ifndef ONEWIRE_ROM_LIST_MAX
+#define ONEWIRE_ROM_LIST_MAX    32
+#endif
+
+#if ONEWIRE_ROM_LIST_MAX > 127
+#error ONEWIRE_ROM_LIST_MAX must fit the int8_t slot of find()
+#endif
+
+// A device is only removed after this many checks or updates in a row did
+// not find it, so a single noise hit on the bus does not lose it.
+#ifndef ONEWIRE_ROM_MISSES
+#define ONEWIRE_ROM_MISSES      3
+#endif
+
+#if ONEWIRE_ROM_MISSES < 1 || ONEWIRE_ROM_MISSES > 3
+#error ONEWIRE_ROM_MISSES must be 1 to 3 (2 bits per slot)
+#endif
+
+// A list of the ROM numbers found on a bus, so the bus does not have to be
+// enumerated with search() on every boot or poll cycle.  The storage is
+// provided by the sketch:
+//
+//    uint8_t roms[4][8];
+//    OneWireRomList list(ds, roms, 4);
+//
+// Devices keep their index when the list is updated: removed devices
+// leave a hole (an all zero ROM, see present()) and new devices go to the
+// first hole, so per device data of the sketch can be indexed the same.
+//
+// The cost of a check is one reset plus 64 search steps per device, i.e.
+// the same as finding it with search(), but check() only does one device
+// per call, so polling can be spread over several loop() iterations.
+class OneWireRomList
+{
+  private:
+    OneWire *bus;
+    uint8_t (*roms)[8];
+    uint8_t capacity;
+    uint8_t checkIdx;
+    uint8_t misses[(ONEWIRE_ROM_LIST_MAX + 3) / 4];   // 2 bits per slot
+
+    uint8_t add(const uint8_t rom[8]);
+    void found(uint8_t idx);
+    uint8_t missed(uint8_t idx);
+
+  public:
+    OneWireRomList(OneWire &ow, uint8_t (*storage)[8], uint8_t size);
+
+    // Number of slots in the list (including holes).
+    uint8_t size(void) { return capacity; }
+
+    // The ROM number in slot 'idx'.
+    const uint8_t *rom(uint8_t idx) { return roms[idx]; }
+
+    // Returns 1 if slot 'idx' holds a device.
+    uint8_t present(uint8_t idx) { return roms[idx][0] != 0; }
+
+    // Number of devices in the list.
+    uint8_t count(void);
+
+    // Returns the slot of 'rom', or -1 if it is not in the list.
+    int8_t find(const uint8_t rom[8]);
+
+    // Empty the list.
+    void clear(void);
+
+    // Enumerate the bus (optionally only the 'family' devices) and merge
+    // the result into the list: known devices keep their slot, devices
+    // not found ONEWIRE_ROM_MISSES times in a row are removed and new ones
+    // are added, so a replaced device takes the slot of the old one even if
+    // the list is full.  A search that finds no device at all (no presence
+    // pulse) removes nothing.  Returns ONEWIRE_ROM_* flags.
+    uint8_t update(void);
+    uint8_t update(uint8_t family);
+
+    // Verify the next device of the list is still present (round-robin),
+    // it is removed once it failed ONEWIRE_ROM_MISSES times in a row.
+    // Returns ONEWIRE_ROM_* flags.
+    uint8_t check(void);
+
+    // Find the devices with an alarm condition (alarm search).  Calls
+    // 'handler' with the slot of each one that is in the list.  Returns
+    // the number of alarms.
+    uint8_t alarms(void (*handler)(uint8_t idx));
+
+#if defined(__AVR__)
+    // Store the list at EEPROM address 'addr' (2 + 8 * size() bytes).
+    // Only bytes that changed are written.
+    void save(uint16_t addr);
+
+    // Restore the list saved at 'addr'. Returns 0 (and leaves the list
+    // empty) if nothing valid was saved there.
+    uint8_t load(uint16_t addr);
+#endif
+};
+
+#endif
+
+#endif
@@ -0,0 +1,52 @@
+#include <OneWire.h>
+#include <OneWireAsync.h>
+#include <DigiUSB.h>
+
+// OneWire DS18B20 readout without blocking the sketch
+//
+// The conversion and the scratchpad readout are clocked by a timer
+// interrupt, one time slot at a time, so DigiUSB keeps being serviced
+// while the bus is busy.  A DS18B20 on pin 5 (with a 4.7K pull-up) is
+// assumed to be the only device on the bus.
+
+OneWireAsync ds(5);
+
+const byte convert[] = { 0xCC, 0x44 };     // Skip ROM, Convert T
+const byte readout[] = { 0xCC, 0xBE };     // Skip ROM, Read Scratchpad
+byte data[9];
+byte step = 0;
+unsigned long converted;
+
+void setup() {
+  DigiUSB.begin();
+}
+
+void loop() {
+  DigiUSB.refresh();
+  if (ds.busy()) return;    // free time for everything else
+
+  switch (step) {
+  case 0:
+    if (ds.start(convert, sizeof(convert))) {
+      converted = millis();
+      step = 1;
+    }
+    break;
+  case 1:
+    if (!ds.presence()) {
+      DigiUSB.println("no device");
+      step = 0;
+    } else if (millis() - converted >= 750) {
+      ds.start(readout, sizeof(readout), data, sizeof(data));
+      step = 2;
+    }
+    break;
+  case 2:
+    if (OneWire::crc8(data, 8) == data[8]) {
+      int16_t raw = (data[1] << 8) | data[0];
+      DigiUSB.println(raw / 16);
+    }
+    step = 0;
+    break;
+  }
+}
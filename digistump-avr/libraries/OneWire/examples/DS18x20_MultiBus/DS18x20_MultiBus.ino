@@ -0,0 +1,42 @@
+#include <OneWire.h>
+#include <OneWirePort.h>
+#include <DigiUSB.h>
+
+// Several DS18B20 strings read in parallel
+//
+// One DS18B20 per bus on pins 0, 2 and 5 (all on PORTB of the Digispark,
+// each with its own 4.7K pull-up).  The conversion is started on all
+// buses with a single command and the scratchpads are read in parallel,
+// so three buses take as long as one.
+
+const byte pins[] = { 0, 2, 5 };
+OneWirePort ds(pins, sizeof(pins));
+byte data[9 * sizeof(pins)];
+
+void setup() {
+  DigiUSB.begin();
+}
+
+void loop() {
+  byte present = ds.reset();
+  ds.skip();
+  ds.write(0x44, 1);        // start conversion on every bus
+  DigiUSB.delay(750);
+
+  ds.reset();
+  ds.skip();
+  ds.write(0xBE);           // Read Scratchpad
+  ds.read_bytes(data, 9);   // 9 bytes from every bus
+
+  for (byte n = 0; n < ds.count(); n++) {
+    byte *sp = data + n * 9;
+    DigiUSB.print(n);
+    DigiUSB.print(": ");
+    if (!(present & (1 << n)) || OneWire::crc8(sp, 8) != sp[8]) {
+      DigiUSB.println("--");
+      continue;
+    }
+    int16_t raw = (sp[1] << 8) | sp[0];
+    DigiUSB.println(raw / 16);
+  }
+}